@@ -0,0 +1,215 @@
+#include "archive.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+// Only the file mapping API; NOGDI / NOUSER keep windows.h from
+// redeclaring raylib names (Rectangle, CloseWindow, DrawText, ...)
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static uint64_t AlignUp(uint64_t v) { return (v + PAK_ALIGN - 1) & ~(PAK_ALIGN - 1); }
+
+// ---------------------------------------------------------
+// Writer
+// ---------------------------------------------------------
+
+bool PakWriter::Add(const char* name, PakEntry entry, const void* data) {
+    if (strlen(name) >= (size_t)PAK_NAME_SIZE) {
+        fprintf(stderr, "pak: name too long: %s\n", name);
+        return false;
+    }
+    strncpy(entry.name, name, PAK_NAME_SIZE);
+    entries.push_back(entry);
+    blobs.push_back(data);
+    return true;
+}
+
+bool PakWriter::AddImage(const char* name, const Image& image) {
+    if (image.data == nullptr || image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 || image.mipmaps != 1) {
+        fprintf(stderr, "pak: %s is not a single-level RGBA8 image\n", name);
+        return false;
+    }
+    PakEntry e{};
+    e.kind = PakKind::IMAGE;
+    e.width = (uint32_t)image.width;
+    e.height = (uint32_t)image.height;
+    e.format = (uint32_t)image.format;
+    e.size = (uint64_t)image.width * image.height * 4;
+    return Add(name, e, image.data);
+}
+
+bool PakWriter::AddWave(const char* name, const Wave& wave) {
+    if (wave.data == nullptr) {
+        fprintf(stderr, "pak: %s has no samples\n", name);
+        return false;
+    }
+    PakEntry e{};
+    e.kind = PakKind::WAVE;
+    e.frameCount = wave.frameCount;
+    e.sampleRate = wave.sampleRate;
+    e.sampleSize = wave.sampleSize;
+    e.channels = wave.channels;
+    e.size = (uint64_t)wave.frameCount * wave.channels * (wave.sampleSize / 8);
+    return Add(name, e, wave.data);
+}
+
+bool PakWriter::AddBlob(const char* name, const void* data, size_t size) {
+    PakEntry e{};
+    e.kind = PakKind::BLOB;
+    e.size = size;
+    return Add(name, e, data);
+}
+
+bool PakWriter::Write(const char* path, uint64_t sourceStamp) const {
+    std::vector<PakEntry> toc = entries;
+    uint64_t offset = AlignUp(sizeof(PakHeader) + toc.size() * sizeof(PakEntry));
+    for (PakEntry& e : toc) {
+        e.offset = offset;
+        offset = AlignUp(offset + e.size);
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "pak: cannot write %s\n", path);
+        return false;
+    }
+
+    PakHeader header{};
+    memcpy(header.magic, PAK_MAGIC, sizeof(header.magic));
+    header.version = PAK_VERSION;
+    header.entryCount = (uint32_t)toc.size();
+    header.sourceStamp = sourceStamp;
+
+    static const unsigned char zeros[PAK_ALIGN] = {};
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if (!toc.empty()) ok = ok && fwrite(toc.data(), sizeof(PakEntry), toc.size(), f) == toc.size();
+    uint64_t written = sizeof(header) + toc.size() * sizeof(PakEntry);
+    for (size_t i = 0; i < toc.size() && ok; ++i) {
+        ok = fwrite(zeros, 1, toc[i].offset - written, f) == toc[i].offset - written;
+        ok = ok && fwrite(blobs[i], 1, toc[i].size, f) == toc[i].size;
+        written = toc[i].offset + toc[i].size;
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok) fprintf(stderr, "pak: write to %s failed\n", path);
+    return ok;
+}
+
+// ---------------------------------------------------------
+// Reader
+// ---------------------------------------------------------
+
+bool AssetArchive::Open(const char* path) {
+    Close();
+
+#ifdef _WIN32
+    // Paths are UTF-8 (as raylib hands them out); the W API takes UTF-16
+    wchar_t widePath[MAX_PATH];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath, MAX_PATH) == 0) return false;
+    HANDLE file = CreateFileW(widePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* mapped = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    // The view keeps the mapping and the file alive
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    if (!mapped) {
+        TraceLog(LOG_WARNING, "PAK: could not map %s", path);
+        return false;
+    }
+    base = (const unsigned char*)mapped;
+    size = (size_t)length.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // the mapping keeps the file alive
+    if (mapped == MAP_FAILED) {
+        TraceLog(LOG_WARNING, "PAK: could not map %s", path);
+        return false;
+    }
+    base = (const unsigned char*)mapped;
+    size = (size_t)st.st_size;
+#endif
+
+    // Validate everything up front so lookups can trust the TOC
+    const PakHeader* header = (const PakHeader*)base;
+    bool valid = size >= sizeof(PakHeader) &&
+                 memcmp(header->magic, PAK_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == PAK_VERSION &&
+                 (size - sizeof(PakHeader)) / sizeof(PakEntry) >= header->entryCount;
+    if (valid) {
+        entries = (const PakEntry*)(base + sizeof(PakHeader));
+        entryCount = header->entryCount;
+        for (uint32_t i = 0; i < entryCount && valid; ++i) {
+            const PakEntry& e = entries[i];
+            valid = e.offset <= size && e.size <= size - e.offset &&
+                    memchr(e.name, '\0', PAK_NAME_SIZE) != nullptr;
+        }
+    }
+    if (!valid) {
+        TraceLog(LOG_WARNING, "PAK: %s is not a version %u archive", path, PAK_VERSION);
+        Close();
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "PAK: mapped %s (%u entries, %zu bytes)", path, entryCount, size);
+    return true;
+}
+
+void AssetArchive::Close() {
+    if (base) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap((void*)base, size);
+#endif
+    }
+    base = nullptr;
+    size = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+const PakEntry* AssetArchive::Find(const char* name) const {
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        if (strcmp(entries[i].name, name) == 0) return &entries[i];
+    }
+    return nullptr;
+}
+
+bool AssetArchive::GetImage(const char* name, Image& out) const {
+    const PakEntry* e = Find(name);
+    if (!e || e->kind != PakKind::IMAGE || e->size != (uint64_t)e->width * e->height * 4) return false;
+    out = { (void*)Data(*e), (int)e->width, (int)e->height, 1, (int)e->format };
+    return true;
+}
+
+bool AssetArchive::GetWave(const char* name, Wave& out) const {
+    const PakEntry* e = Find(name);
+    if (!e || e->kind != PakKind::WAVE) return false;
+    if (e->size != (uint64_t)e->frameCount * e->channels * (e->sampleSize / 8)) return false;
+    out = { e->frameCount, e->sampleRate, e->sampleSize, e->channels, (void*)Data(*e) };
+    return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "raylib.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// ---------------------------------------------------------
+// Asset archive (.pak)
+//
+// One file holding every asset already decoded: RGBA8 pixels and PCM in
+// the format the audio device runs at, so startup never touches a PNG or
+// WAV parser. The music track is the exception: it is kept compressed as
+// a blob, since the mixer streams it. Layout:
+//
+//   PakHeader | PakEntry[entryCount] | data blobs (PAK_ALIGN aligned)
+//
+// All fields are little-endian, native layout; the archive is built on
+// the same kind of machine it ships to. The header carries a stamp of
+// the source files it was packed from so a dev build can tell when the
+// loose files have moved on. The runtime maps the file and
+// hands pointers into the mapping straight to the GPU / audio uploads.
+// ---------------------------------------------------------
+
+static const char PAK_MAGIC[8] = { 'B', 'E', 'A', 'T', 'P', 'A', 'K', '\0' };
+static const uint32_t PAK_VERSION = 3;
+static const int PAK_NAME_SIZE = 48;
+static const uint64_t PAK_ALIGN = 64;
+
+// Format the audio mixer runs at (32-bit float, stereo); sounds stored
+// like this are copied in without a conversion pass
+static const int PAK_SAMPLE_RATE = 44100;
+static const int PAK_SAMPLE_SIZE = 32;
+static const int PAK_CHANNELS = 2;
+
+enum class PakKind : uint32_t { IMAGE, WAVE, BLOB };
+
+struct PakHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t sourceStamp;   // opaque to the archive; see PackAssetArchive
+};
+
+struct PakEntry {
+    char name[PAK_NAME_SIZE];
+    PakKind kind;
+    uint32_t width;        // IMAGE
+    uint32_t height;
+    uint32_t format;       // PixelFormat
+    uint32_t frameCount;   // WAVE
+    uint32_t sampleRate;
+    uint32_t sampleSize;
+    uint32_t channels;
+    uint64_t offset;       // from the start of the file
+    uint64_t size;         // bytes
+};
+
+// Offline side: collects entries and writes the archive in one go.
+// Added data is referenced, not copied, until Write.
+struct PakWriter {
+    bool AddImage(const char* name, const Image& image);   // must be R8G8B8A8
+    bool AddWave(const char* name, const Wave& wave);
+    bool AddBlob(const char* name, const void* data, size_t size);
+
+    bool Write(const char* path, uint64_t sourceStamp) const;
+
+private:
+    bool Add(const char* name, PakEntry entry, const void* data);
+
+    std::vector<PakEntry> entries;
+    std::vector<const void*> blobs;
+};
+
+// Runtime side: the whole file mapped read-only (MapViewOfFile on
+// Windows, mmap elsewhere). Entry data stays valid until Close.
+struct AssetArchive {
+    AssetArchive() = default;
+    ~AssetArchive() { Close(); }
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    // false (and logs why) when the file is missing or malformed
+    bool Open(const char* path);
+    void Close();
+
+    bool IsOpen() const { return base != nullptr; }
+    uint64_t SourceStamp() const { return ((const PakHeader*)base)->sourceStamp; }
+
+    const PakEntry* Find(const char* name) const;
+    const void* Data(const PakEntry& e) const { return base + e.offset; }
+
+    // Views over the mapped data; never unload these
+    bool GetImage(const char* name, Image& out) const;
+    bool GetWave(const char* name, Wave& out) const;
+
+private:
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+    const PakEntry* entries = nullptr;
+    uint32_t entryCount = 0;
+};
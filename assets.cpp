@@ -0,0 +1,252 @@
+#include "assets.h"
+#include "trace.h"
+#include <cstdio>
+#include <cstring>
+
+// Atlas entries in the archive; sounds are stored under their file name
+static const char* PAK_ATLAS = "atlas";
+static const char* PAK_ATLAS_RECTS = "atlas.rects";
+
+static_assert(PAK_SAMPLE_RATE == MIXER_SAMPLE_RATE && PAK_SAMPLE_SIZE == 32 && PAK_CHANNELS == MIXER_CHANNELS,
+              "archive audio should be stored in the mixer's format");
+
+void GetAudioPaths(const char* paths[AUDIO_CLIP_COUNT]) {
+    paths[(int)Sfx::KNIGHT_SWING] = "sfx_knight_swing.wav";
+    paths[(int)Sfx::ROGUE_SWING]  = "sfx_rogue_swing.wav";
+    paths[(int)Sfx::MAGE_CAST]    = "sfx_mage_cast.wav";
+    paths[(int)Sfx::HIT]          = "sfx_hit.wav";
+    paths[(int)Sfx::ENEMY_SWING]  = "sfx_enemy_swing.wav";
+    paths[(int)Sfx::BLOCK]        = "sfx_block.wav";
+    paths[(int)Sfx::DODGE]        = "sfx_dodge.wav";
+    paths[(int)Sfx::BLINK]        = "sfx_blink.wav";
+    paths[AUDIO_MUSIC]            = "music.ogg";   // optional
+}
+
+AssetLoader::~AssetLoader() {
+    Join();
+    for (Image& img : images) {
+        if (img.data) UnloadImage(img);
+    }
+    for (Wave& w : waves) {
+        if (w.data) UnloadWave(w);
+    }
+    if (musicData) UnloadFileData(musicData);
+    if (packedImage.data) UnloadImage(packedImage);
+}
+
+void AssetLoader::Start(int threadCount) {
+    GetSpritePaths(imagePaths);
+    GetAudioPaths(wavePaths);
+    ResolveAssetFiles(files);
+
+    if (threadCount < 1) threadCount = 1;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&AssetLoader::Worker, this);
+    }
+}
+
+void AssetLoader::Worker() {
+    TRACE_THREAD_NAME("asset loader");
+    for (;;) {
+        int item = next.fetch_add(1, std::memory_order_relaxed);
+        if (item >= Total()) return;
+
+        if (item < SPRITE_COUNT) {
+            TRACE_SCOPE(imagePaths[item] ? imagePaths[item] : "generated sprite");
+            const char* path = files.Sprite(item);
+            if (path && FileExists(path)) images[item] = LoadImage(path);
+        } else {
+            int clip = item - SPRITE_COUNT;
+            TRACE_SCOPE(wavePaths[clip]);
+            const char* path = files.Audio(clip);
+            if (FileExists(path)) {
+                if (clip == AUDIO_MUSIC) musicData = LoadFileData(path, &musicSize);
+                else waves[clip] = LoadWave(path);
+            }
+        }
+
+        // Whoever decodes the last file packs the atlas
+        if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == Total()) {
+            TRACE_SCOPE("pack atlas");
+            packedImage = PackSpriteAtlas(images, packedAtlas);
+            packed.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void AssetLoader::Join() {
+    for (auto& t : threads) {
+        if (t.joinable()) t.join();
+    }
+    threads.clear();
+}
+
+void AssetLoader::Finish(SpriteAtlas& atlas, AudioMixer& mixer) {
+    TRACE_SCOPE("upload assets");
+    Join();
+
+    for (int id = 0; id < SPRITE_COUNT; ++id) atlas.rects[id] = packedAtlas.rects[id];
+    UploadSpriteAtlas(atlas, packedImage);
+    UnloadImage(packedImage);
+    packedImage = Image{};
+
+    for (Image& img : images) {
+        if (img.data) UnloadImage(img);
+        img = Image{};
+    }
+
+    for (int i = 0; i < SOUND_COUNT; ++i) {
+        if (!waves[i].data) continue;
+        mixer.SetSound((Sfx)i, waves[i]);
+        UnloadWave(waves[i]);
+        waves[i] = Wave{};
+    }
+
+    if (musicData) {
+        mixer.SetMusic(musicData, (size_t)musicSize);
+        UnloadFileData(musicData);
+        musicData = nullptr;
+    }
+}
+
+// ---------------------------------------------------------
+// Archive
+// ---------------------------------------------------------
+
+std::string AppRelativePath(const char* relative) {
+    const char* dir = GetApplicationDirectory();
+    return std::string(dir ? dir : "") + relative;
+}
+
+std::string AssetArchivePath() {
+    return AppRelativePath(ASSET_ARCHIVE_NAME);
+}
+
+void ResolveAssetFiles(AssetFiles& out, const EnemyArchetype archetypes[ENEMY_TYPE_COUNT]) {
+    const char* spritePaths[SPRITE_COUNT];
+    const char* audioPaths[AUDIO_CLIP_COUNT];
+    GetSpritePaths(spritePaths, archetypes);
+    GetAudioPaths(audioPaths);
+    for (int id = 0; id < SPRITE_COUNT; ++id) {
+        out.sprites[id] = spritePaths[id] ? AppRelativePath(spritePaths[id]) : std::string();
+    }
+    for (int i = 0; i < AUDIO_CLIP_COUNT; ++i) out.audio[i] = AppRelativePath(audioPaths[i]);
+}
+
+// FNV-1a over every source name and its file's mod time, plus the table
+// sizes. Names are hashed relative, so moving the install doesn't count
+// as a change. `present` says whether any of the sources exist here at
+// all; a shipped build has none and just trusts its archive.
+static uint64_t SourceStamp(bool& present) {
+    const char* spritePaths[SPRITE_COUNT];
+    const char* audioPaths[AUDIO_CLIP_COUNT];
+    GetSpritePaths(spritePaths);
+    GetAudioPaths(audioPaths);
+    AssetFiles files;
+    ResolveAssetFiles(files);
+
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void* data, size_t size) {
+        const unsigned char* p = (const unsigned char*)data;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    auto mixFile = [&](const char* name, const char* file) {
+        if (!name) return;
+        long long modTime = FileExists(file) ? (long long)GetFileModTime(file) : 0;
+        if (modTime != 0) present = true;
+        mix(name, strlen(name) + 1);
+        mix(&modTime, sizeof(modTime));
+    };
+
+    present = false;
+    const int counts[2] = { SPRITE_COUNT, AUDIO_CLIP_COUNT };
+    mix(counts, sizeof(counts));
+    for (int id = 0; id < SPRITE_COUNT; ++id) mixFile(spritePaths[id], files.Sprite(id));
+    for (int i = 0; i < AUDIO_CLIP_COUNT; ++i) mixFile(audioPaths[i], files.Audio(i));
+    return h;
+}
+
+bool PackAssetArchive(const char* path) {
+    const char* audioPaths[AUDIO_CLIP_COUNT];   // archive names
+    GetAudioPaths(audioPaths);
+    AssetFiles files;
+    ResolveAssetFiles(files);
+
+    Image images[SPRITE_COUNT] = {};
+    for (int id = 0; id < SPRITE_COUNT; ++id) {
+        const char* file = files.Sprite(id);
+        if (file && FileExists(file)) images[id] = LoadImage(file);
+    }
+    SpriteAtlas atlas;
+    Image packed = PackSpriteAtlas(images, atlas);
+
+    Wave waves[SOUND_COUNT] = {};
+    unsigned char* music = nullptr;
+    int musicSize = 0;
+    for (int i = 0; i < AUDIO_CLIP_COUNT; ++i) {
+        if (!FileExists(files.Audio(i))) {
+            printf("pack: skipping missing %s\n", files.Audio(i));
+            continue;
+        }
+        if (i == AUDIO_MUSIC) {
+            music = LoadFileData(files.Audio(i), &musicSize);   // streamed, stays compressed
+            continue;
+        }
+        waves[i] = LoadWave(files.Audio(i));
+        if (waves[i].data) WaveFormat(&waves[i], PAK_SAMPLE_RATE, PAK_SAMPLE_SIZE, PAK_CHANNELS);
+    }
+
+    PakWriter writer;
+    bool ok = writer.AddImage(PAK_ATLAS, packed) &&
+              writer.AddBlob(PAK_ATLAS_RECTS, atlas.rects, sizeof(atlas.rects));
+    for (int i = 0; i < SOUND_COUNT && ok; ++i) {
+        if (waves[i].data) ok = writer.AddWave(audioPaths[i], waves[i]);
+    }
+    if (music && ok) ok = writer.AddBlob(audioPaths[AUDIO_MUSIC], music, (size_t)musicSize);
+    bool present;
+    ok = ok && writer.Write(path, SourceStamp(present));
+    if (ok) printf("pack: wrote %s (atlas %dx%d)\n", path, packed.width, packed.height);
+
+    UnloadImage(packed);
+    for (Image& img : images) {
+        if (img.data) UnloadImage(img);
+    }
+    for (Wave& w : waves) {
+        if (w.data) UnloadWave(w);
+    }
+    if (music) UnloadFileData(music);
+    return ok;
+}
+
+bool LoadAssetArchive(const AssetArchive& archive, SpriteAtlas& atlas, AudioMixer& mixer) {
+    TRACE_SCOPE("load archive");
+    bool present;
+    if (SourceStamp(present) != archive.SourceStamp() && present) {
+        TraceLog(LOG_WARNING, "PAK: archive is older than the loose asset files; loading those instead");
+        return false;
+    }
+
+    const PakEntry* rects = archive.Find(PAK_ATLAS_RECTS);
+    Image packed;
+    if (!rects || rects->size != sizeof(atlas.rects) || !archive.GetImage(PAK_ATLAS, packed)) {
+        TraceLog(LOG_WARNING, "PAK: archive does not match this build's sprite set");
+        return false;
+    }
+
+    // Both uploads read the mapped file directly
+    memcpy(atlas.rects, archive.Data(*rects), sizeof(atlas.rects));
+    UploadSpriteAtlas(atlas, packed);
+
+    const char* audioPaths[AUDIO_CLIP_COUNT];
+    GetAudioPaths(audioPaths);
+    for (int i = 0; i < SOUND_COUNT; ++i) {
+        Wave wave;
+        if (archive.GetWave(audioPaths[i], wave)) mixer.SetSound((Sfx)i, wave);
+    }
+    const PakEntry* music = archive.Find(audioPaths[AUDIO_MUSIC]);
+    if (music && music->kind == PakKind::BLOB) mixer.SetMusic(archive.Data(*music), (size_t)music->size);
+    return true;
+}
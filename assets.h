@@ -0,0 +1,108 @@
+#pragma once
+
+#include "raylib.h"
+#include "atlas.h"
+#include "events.h"
+#include "archive.h"
+#include "audio.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// ---------------------------------------------------------
+// Asynchronous asset loading
+//
+// Image and wave files are decoded on worker threads (LoadImage /
+// LoadWave), and the worker that finishes last also packs the sprite
+// atlas. The main thread keeps presenting a progress screen and only
+// does the GPU and audio uploads in Finish, once everything is decoded.
+//
+// A shipped build skips all of that: the packer (--pack-assets) bakes the
+// atlas and the converted audio into one archive next to the executable,
+// and LoadAssetArchive uploads straight out of the mapped file.
+//
+// Audio clips are the Sfx sounds in enum order, then the music track.
+// Sounds are decoded; the music file is only read, and stays compressed
+// for the mixer to stream.
+// ---------------------------------------------------------
+
+static const char* ASSET_ARCHIVE_NAME = "assets.pak";
+static const int AUDIO_MUSIC = SOUND_COUNT;
+static const int AUDIO_CLIP_COUNT = SOUND_COUNT + 1;
+
+// Audio file per clip, relative to the executable (also the clip's
+// name in the archive)
+void GetAudioPaths(const char* paths[AUDIO_CLIP_COUNT]);
+
+// `relative` resolved against the executable's directory, so lookups
+// do not depend on the working directory
+std::string AppRelativePath(const char* relative);
+
+// Every loose asset file, resolved with AppRelativePath. The loader, the
+// packer, the stale-archive stamp and the hot-reload watcher all open
+// files through this, never through the relative names.
+struct AssetFiles {
+    std::string sprites[SPRITE_COUNT];      // empty for generated sprites
+    std::string audio[AUDIO_CLIP_COUNT];
+
+    const char* Sprite(int id) const { return sprites[id].empty() ? nullptr : sprites[id].c_str(); }
+    const char* Audio(int clip) const { return audio[clip].c_str(); }
+};
+
+// Sprite sheets named by `archetypes`, like GetSpritePaths
+void ResolveAssetFiles(AssetFiles& out, const EnemyArchetype archetypes[ENEMY_TYPE_COUNT] = enemyArchetypes);
+
+// Archive next to the executable
+std::string AssetArchivePath();
+
+// Offline: decodes the loose files and writes the archive to `path`
+bool PackAssetArchive(const char* path);
+
+// Uploads the atlas and hands the audio to the mixer from an open
+// archive. False when the archive lacks the atlas, was packed for a
+// different sprite set, or the loose files it was packed from have
+// changed since (then the caller falls back to them).
+bool LoadAssetArchive(const AssetArchive& archive, SpriteAtlas& atlas, AudioMixer& mixer);
+
+struct AssetLoader {
+    AssetLoader() = default;
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Starts decoding and returns immediately. Missing files are skipped
+    // without touching the decoders.
+    void Start(int threadCount);
+
+    int Total() const { return SPRITE_COUNT + AUDIO_CLIP_COUNT; }
+    int Done() const { return done.load(std::memory_order_relaxed); }
+
+    // All files decoded and the atlas packed
+    bool Decoded() const { return packed.load(std::memory_order_acquire); }
+
+    // Main thread, after Decoded(): uploads the atlas texture, hands the
+    // audio to the mixer and frees the CPU copies.
+    void Finish(SpriteAtlas& atlas, AudioMixer& mixer);
+
+private:
+    void Worker();
+    void Join();
+
+    const char* imagePaths[SPRITE_COUNT] = {};      // relative; trace labels
+    const char* wavePaths[AUDIO_CLIP_COUNT] = {};
+    AssetFiles files;
+    Image images[SPRITE_COUNT] = {};
+    Wave waves[SOUND_COUNT] = {};
+    unsigned char* musicData = nullptr;   // compressed file
+    int musicSize = 0;
+
+    SpriteAtlas packedAtlas;   // rects only, filled by the packing worker
+    Image packedImage{};
+
+    std::vector<std::thread> threads;
+    std::atomic<int> next{ 0 };
+    std::atomic<int> done{ 0 };
+    std::atomic<bool> packed{ false };
+};
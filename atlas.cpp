@@ -0,0 +1,153 @@
+#include "atlas.h"
+#include "rlgl.h"
+#include <algorithm>
+
+static const int WHITE_SIZE = 3;      // only the centre texel is sampled
+static const int SHADOW_WIDTH = 64;
+static const int SHADOW_HEIGHT = 16;
+
+void GetSpritePaths(const char* paths[SPRITE_COUNT], const EnemyArchetype archetypes[ENEMY_TYPE_COUNT]) {
+    paths[SPRITE_KNIGHT]     = "assets/knight.png";
+    paths[SPRITE_ROGUE]      = "assets/rogue.png";
+    paths[SPRITE_MAGE]       = "assets/mage.png";
+    paths[SPRITE_COIN]       = "assets/coin.png";
+    paths[SPRITE_PROJECTILE] = "assets/projectile.png"; // optional
+    paths[SPRITE_WHITE]      = nullptr;
+    paths[SPRITE_SHADOW]     = nullptr;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) {
+        paths[EnemySpriteId((EnemyType)t)] = archetypes[t].sprite;
+    }
+}
+
+// White ellipse filling the image; tinted when drawn
+static Image MakeShadowImage() {
+    Image img = GenImageColor(SHADOW_WIDTH, SHADOW_HEIGHT, BLANK);
+    float rx = SHADOW_WIDTH * 0.5f;
+    float ry = SHADOW_HEIGHT * 0.5f;
+    for (int y = 0; y < SHADOW_HEIGHT; ++y) {
+        for (int x = 0; x < SHADOW_WIDTH; ++x) {
+            float dx = (x + 0.5f - rx) / rx;
+            float dy = (y + 0.5f - ry) / ry;
+            if (dx * dx + dy * dy <= 1.0f) ImageDrawPixel(&img, x, y, WHITE);
+        }
+    }
+    return img;
+}
+
+Image PackSpriteAtlas(const Image images[SPRITE_COUNT], SpriteAtlas& atlas) {
+    Image src[SPRITE_COUNT];
+    for (int id = 0; id < SPRITE_COUNT; ++id) src[id] = images[id];
+    src[SPRITE_WHITE] = GenImageColor(WHITE_SIZE, WHITE_SIZE, WHITE);
+    src[SPRITE_SHADOW] = MakeShadowImage();
+
+    // Shelf packing, tallest first
+    int order[SPRITE_COUNT];
+    for (int id = 0; id < SPRITE_COUNT; ++id) order[id] = id;
+    std::stable_sort(order, order + SPRITE_COUNT, [&](int a, int b) {
+        return src[a].height > src[b].height;
+    });
+
+    int x = ATLAS_PADDING;
+    int y = ATLAS_PADDING;
+    int shelfHeight = 0;
+    for (int id : order) {
+        atlas.rects[id] = { 0, 0, 0, 0 };
+        if (src[id].data == nullptr) continue;
+
+        int w = src[id].width;
+        int h = src[id].height;
+        if (w + 2 * ATLAS_PADDING > ATLAS_WIDTH) {
+            TraceLog(LOG_WARNING, "ATLAS: sprite %d is %dpx wide, atlas is %dpx", id, w, ATLAS_WIDTH);
+            continue;
+        }
+        if (x + w + ATLAS_PADDING > ATLAS_WIDTH) {
+            x = ATLAS_PADDING;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        atlas.rects[id] = { (float)x, (float)y, (float)w, (float)h };
+        x += w + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+
+    int height = 1;
+    while (height < y + shelfHeight + ATLAS_PADDING) height *= 2;
+
+    Image packed = GenImageColor(ATLAS_WIDTH, height, BLANK);
+    for (int id = 0; id < SPRITE_COUNT; ++id) {
+        if (!atlas.Has(id)) continue;
+        Rectangle whole = { 0, 0, (float)src[id].width, (float)src[id].height };
+        ImageDraw(&packed, src[id], whole, atlas.rects[id], WHITE);
+    }
+
+    // Shapes sample the centre of the white block so filtering never
+    // reaches a neighbour
+    Rectangle& white = atlas.rects[SPRITE_WHITE];
+    white = { white.x + WHITE_SIZE / 2, white.y + WHITE_SIZE / 2, 1, 1 };
+
+    UnloadImage(src[SPRITE_WHITE]);
+    UnloadImage(src[SPRITE_SHADOW]);
+    return packed;
+}
+
+void UploadSpriteAtlas(SpriteAtlas& atlas, const Image& packed) {
+    atlas.texture = LoadTextureFromImage(packed);
+    if (atlas.texture.id > 0) {
+        SetShapesTexture(atlas.texture, atlas.rects[SPRITE_WHITE]);
+    }
+}
+
+void UnloadSpriteAtlas(SpriteAtlas& atlas) {
+    // Back to raylib's default 1x1 white texture
+    Texture2D defaultTex = { rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    SetShapesTexture(defaultTex, { 0, 0, 1, 1 });
+
+    if (atlas.texture.id > 0) UnloadTexture(atlas.texture);
+    atlas = SpriteAtlas{};
+}
+
+// ---------------------------------------------------------
+// Batch
+// ---------------------------------------------------------
+
+void SpriteBatch::Draw(Rectangle src, Rectangle dst, Vector2 origin, bool flipX, Color tint) {
+    const Texture2D& tex = atlas->texture;
+    if (tex.id == 0) return;
+
+    float iw = 1.0f / (float)tex.width;
+    float ih = 1.0f / (float)tex.height;
+    float u0 = src.x * iw;
+    float u1 = (src.x + src.width) * iw;
+    float v0 = src.y * ih;
+    float v1 = (src.y + src.height) * ih;
+    if (flipX) std::swap(u0, u1);
+
+    float x0 = dst.x - origin.x;
+    float y0 = dst.y - origin.y;
+    float x1 = x0 + dst.width;
+    float y1 = y0 + dst.height;
+
+    // Same texture every call, so rlgl keeps appending to one draw
+    rlSetTexture(tex.id);
+    rlBegin(RL_QUADS);
+        rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+
+        rlTexCoord2f(u0, v0); rlVertex2f(x0, y0);
+        rlTexCoord2f(u0, v1); rlVertex2f(x0, y1);
+        rlTexCoord2f(u1, v1); rlVertex2f(x1, y1);
+        rlTexCoord2f(u1, v0); rlVertex2f(x1, y0);
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void SpriteBatch::DrawSprite(int id, Vector2 pos, float scale, Vector2 origin, Color tint) {
+    const Rectangle& src = atlas->rects[id];
+    Rectangle dst = { pos.x, pos.y, src.width * scale, src.height * scale };
+    Draw(src, dst, { dst.width * origin.x, dst.height * origin.y }, false, tint);
+}
+
+void SpriteBatch::DrawShadow(float x, float y, float radiusH, float radiusV, Color tint) {
+    Rectangle dst = { x - radiusH, y - radiusV, radiusH * 2.0f, radiusV * 2.0f };
+    Draw(atlas->rects[SPRITE_SHADOW], dst, { 0, 0 }, false, tint);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "raylib.h"
+#include "enemies.h"
+
+// ---------------------------------------------------------
+// Sprite atlas + batch
+//
+// Every sprite sheet is packed into one texture when the game loads,
+// together with a white texel (handed to SetShapesTexture so rectangles
+// and circles sample the same texture) and a soft shadow ellipse. With
+// a single texture bound, raylib's render batch never has to flush
+// between sprites, so the world draws in a constant number of draw
+// calls however many enemies and coins are on screen.
+// ---------------------------------------------------------
+
+enum SpriteId {
+    SPRITE_KNIGHT,
+    SPRITE_ROGUE,
+    SPRITE_MAGE,
+    SPRITE_COIN,
+    SPRITE_PROJECTILE,
+    SPRITE_WHITE,        // generated
+    SPRITE_SHADOW,       // generated
+    SPRITE_ENEMY_FIRST,  // one per EnemyType
+    SPRITE_COUNT = SPRITE_ENEMY_FIRST + ENEMY_TYPE_COUNT
+};
+
+inline int EnemySpriteId(EnemyType t) { return SPRITE_ENEMY_FIRST + (int)t; }
+
+static const int ATLAS_WIDTH = 512;
+static const int ATLAS_PADDING = 2;   // transparent gap between sheets
+
+struct SpriteAtlas {
+    Texture2D texture{};
+    Rectangle rects[SPRITE_COUNT]{};   // zero size = image was missing
+
+    bool Has(int id) const { return rects[id].width > 0; }
+
+    // Cell (col, row) of a sheet laid out as cols x rows equal frames
+    Rectangle Frame(int id, int cols, int rows, int col, int row) const {
+        const Rectangle& r = rects[id];
+        float w = (float)((int)r.width / cols);
+        float h = (float)((int)r.height / rows);
+        return { r.x + w * col, r.y + h * row, w, h };
+    }
+};
+
+// Image file per sprite (nullptr for the generated ones), relative to
+// the executable; ResolveAssetFiles (assets.h) turns them into paths to
+// open. Enemy sheets come from `archetypes`; the paths point into that table.
+void GetSpritePaths(const char* paths[SPRITE_COUNT], const EnemyArchetype archetypes[ENEMY_TYPE_COUNT] = enemyArchetypes);
+
+// CPU half: packs `images` (missing ones have no data) plus the generated
+// sprites into one RGBA image and fills atlas.rects. Safe off the main thread.
+Image PackSpriteAtlas(const Image images[SPRITE_COUNT], SpriteAtlas& atlas);
+
+// GPU half: uploads the packed image and routes shape drawing through it
+void UploadSpriteAtlas(SpriteAtlas& atlas, const Image& packed);
+
+void UnloadSpriteAtlas(SpriteAtlas& atlas);
+
+// Axis-aligned textured quads straight into the rlgl batch. Same
+// dst/origin convention as DrawTexturePro, minus the rotation.
+struct SpriteBatch {
+    const SpriteAtlas* atlas = nullptr;
+
+    void Begin(const SpriteAtlas& a) { atlas = &a; }
+    void End() { atlas = nullptr; }
+
+    void Draw(Rectangle src, Rectangle dst, Vector2 origin, bool flipX, Color tint);
+
+    // Whole sprite `id` scaled around `origin` (fractions of the drawn size)
+    void DrawSprite(int id, Vector2 pos, float scale, Vector2 origin, Color tint);
+
+    // Ground shadow centred on (x, y), radii in pixels like DrawEllipse
+    void DrawShadow(float x, float y, float radiusH, float radiusV, Color tint);
+};
@@ -0,0 +1,243 @@
+#include "audio.h"
+#include "trace.h"
+#include <chrono>
+#include <cstring>
+
+// raylib's stream callback has no user pointer
+static AudioMixer* activeMixer = nullptr;
+
+static const unsigned int MIXER_BUFFER_FRAMES = 1024;
+
+void AudioMixer::CopyClip(Clip& clip, const Wave& wave) {
+    clip = Clip{};
+    if (wave.data == nullptr || wave.frameCount == 0) return;
+
+    // Archive waves are stored in this format already and copy straight
+    Wave w = wave;
+    bool converted = wave.sampleRate != (unsigned)MIXER_SAMPLE_RATE || wave.sampleSize != 32 ||
+                     wave.channels != (unsigned)MIXER_CHANNELS;
+    if (converted) {
+        w = WaveCopy(wave);
+        WaveFormat(&w, MIXER_SAMPLE_RATE, 32, MIXER_CHANNELS);
+    }
+    clip.frames = w.frameCount;
+    clip.samples.assign((const float*)w.data, (const float*)w.data + (size_t)w.frameCount * MIXER_CHANNELS);
+    if (converted) UnloadWave(w);
+}
+
+void AudioMixer::SetSound(Sfx s, const Wave& wave) { CopyClip(sounds[(int)s], wave); }
+void AudioMixer::SetMusic(const void* oggData, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)oggData;
+    musicData.assign(bytes, bytes + (oggData ? size : 0));
+}
+
+float AudioMixer::SoundLength(Sfx s) const {
+    return (float)sounds[(int)s].frames / (float)MIXER_SAMPLE_RATE;
+}
+
+void AudioMixer::Start() {
+    if (started || activeMixer != nullptr || !IsAudioDeviceReady()) return;
+
+    SetAudioStreamBufferSizeDefault(MIXER_BUFFER_FRAMES);
+    stream = LoadAudioStream(MIXER_SAMPLE_RATE, 32, MIXER_CHANNELS);
+    SetAudioStreamBufferSizeDefault(0);
+    if (!IsAudioStreamValid(stream)) {
+        TraceLog(LOG_WARNING, "MIXER: could not open the output stream");
+        return;
+    }
+
+    activeMixer = this;
+    SetAudioStreamCallback(stream, &AudioMixer::Callback);
+    PlayAudioStream(stream);
+    started = true;
+
+    // Larger buffers than the mixer's: the music thread is not realtime
+    // and only has to refill one every few of its wakeups
+    if (!musicData.empty()) {
+        SetAudioStreamBufferSizeDefault(MUSIC_BUFFER_FRAMES);
+        music = LoadMusicStreamFromMemory(".ogg", musicData.data(), (int)musicData.size());
+        SetAudioStreamBufferSizeDefault(0);
+        if (IsMusicValid(music)) {
+            music.looping = true;
+            musicRunning.store(true, std::memory_order_relaxed);
+            musicThread = std::thread(&AudioMixer::MusicThread, this);
+        } else {
+            TraceLog(LOG_WARNING, "MIXER: could not open the music stream");
+        }
+    }
+}
+
+void AudioMixer::Shutdown() {
+    if (!started) return;
+    // Unloading takes raylib's audio lock, so no callback is in flight after
+    StopAudioStream(stream);
+    UnloadAudioStream(stream);
+    stream = AudioStream{};
+    activeMixer = nullptr;
+    started = false;
+
+    musicRunning.store(false, std::memory_order_relaxed);
+    if (musicThread.joinable()) musicThread.join();
+    if (IsMusicValid(music)) UnloadMusicStream(music);
+    music = Music{};
+}
+
+// ---------------------------------------------------------
+// Music decoder thread
+// ---------------------------------------------------------
+
+void AudioMixer::MusicThread() {
+    TRACE_THREAD_NAME("music");
+
+    bool playing = false;
+    bool begun = false;
+    float gain = -1.0f;
+    while (musicRunning.load(std::memory_order_relaxed)) {
+        bool want = musicPlaying.load(std::memory_order_relaxed);
+        if (want != playing) {
+            if (!want) PauseMusicStream(music);
+            else if (begun) ResumeMusicStream(music);
+            else PlayMusicStream(music);
+            begun = begun || want;
+            playing = want;
+        }
+        float g = musicGain.load(std::memory_order_relaxed);
+        if (g != gain) {
+            ::SetMusicVolume(music, g);
+            gain = g;
+        }
+
+        if (playing) {
+            TRACE_SCOPE("decode music");
+            UpdateMusicStream(music);   // decodes only when a buffer was consumed
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(MUSIC_UPDATE_MS));
+    }
+
+    StopMusicStream(music);
+}
+
+// ---------------------------------------------------------
+// Game thread
+// ---------------------------------------------------------
+
+#if !defined(NO_PROFILER)
+static const char* AudioOpName(AudioOp op) {
+    switch (op) {
+    case AudioOp::PLAY:          return "audio play";
+    case AudioOp::STOP:          return "audio stop";
+    case AudioOp::VOLUME:        return "audio volume";
+    case AudioOp::MASTER_VOLUME: return "master volume";
+    }
+    return "audio";
+}
+#endif
+
+bool AudioMixer::Send(const AudioCommand& cmd) {
+    if (!started) return false;
+    TRACE_INSTANT(AudioOpName(cmd.op));
+    if (queue.Push(cmd)) return true;
+    counters.queueFull.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool AudioMixer::Play(int voice, Sfx s, float volume) {
+    return Send({ AudioOp::PLAY, (uint8_t)voice, (uint8_t)s, volume });
+}
+void AudioMixer::Stop(int voice) { Send({ AudioOp::STOP, (uint8_t)voice, 0, 0.0f }); }
+void AudioMixer::SetVoiceVolume(int voice, float volume) { Send({ AudioOp::VOLUME, (uint8_t)voice, 0, volume }); }
+void AudioMixer::SetMasterVolume(float volume) {
+    masterVolumeSet = volume;
+    UpdateMusicGain();
+    Send({ AudioOp::MASTER_VOLUME, 0, 0, volume });
+}
+
+// Music goes straight to the music thread's atomics, not the queue
+void AudioMixer::PlayMusic(float volume) {
+    musicVolumeSet = volume;
+    UpdateMusicGain();
+    TRACE_INSTANT("music play");
+    musicPlaying.store(true, std::memory_order_relaxed);
+}
+void AudioMixer::StopMusic() {
+    TRACE_INSTANT("music stop");
+    musicPlaying.store(false, std::memory_order_relaxed);
+}
+void AudioMixer::SetMusicVolume(float volume) {
+    musicVolumeSet = volume;
+    UpdateMusicGain();
+}
+void AudioMixer::UpdateMusicGain() {
+    musicGain.store(musicVolumeSet * masterVolumeSet, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------
+// Audio thread
+// ---------------------------------------------------------
+
+void AudioMixer::Callback(void* buffer, unsigned int frames) {
+    if (activeMixer) activeMixer->Mix((float*)buffer, frames);
+    else memset(buffer, 0, (size_t)frames * MIXER_CHANNELS * sizeof(float));
+}
+
+void AudioMixer::Apply(const AudioCommand& cmd) {
+    switch (cmd.op) {
+        case AudioOp::PLAY:
+            if (cmd.voice < MIXER_VOICES && cmd.sound < SOUND_COUNT && sounds[cmd.sound].frames > 0) {
+                voices[cmd.voice] = { &sounds[cmd.sound], 0, cmd.volume };
+            }
+            break;
+        case AudioOp::STOP:
+            if (cmd.voice < MIXER_VOICES) voices[cmd.voice].clip = nullptr;
+            break;
+        case AudioOp::VOLUME:
+            if (cmd.voice < MIXER_VOICES) voices[cmd.voice].volume = cmd.volume;
+            break;
+        case AudioOp::MASTER_VOLUME:
+            masterVolume = cmd.volume;
+            break;
+    }
+}
+
+void AudioMixer::Mix(float* out, unsigned int frames) {
+    // No trace scopes here: registering a trace buffer allocates and locks
+    // on the device thread. Mix time goes to the atomic counters instead.
+    auto start = std::chrono::steady_clock::now();
+
+    int depth = (int)queue.Size();
+    counters.queueDepth.store(depth, std::memory_order_relaxed);
+    if (depth > counters.queueHigh.load(std::memory_order_relaxed)) {
+        counters.queueHigh.store(depth, std::memory_order_relaxed);
+    }
+    AudioCommand cmd;
+    while (queue.Pop(cmd)) Apply(cmd);
+
+    const size_t samples = (size_t)frames * MIXER_CHANNELS;
+    memset(out, 0, samples * sizeof(float));
+
+    // Voices stop at the end of their clip
+    int active = 0;
+    for (Voice& v : voices) {
+        if (!v.clip) continue;
+        uint32_t n = v.clip->frames - v.cursor;
+        if (n > frames) n = frames;
+        const float* src = &v.clip->samples[(size_t)v.cursor * MIXER_CHANNELS];
+        for (uint32_t i = 0; i < n * MIXER_CHANNELS; ++i) out[i] += src[i] * v.volume;
+        v.cursor += n;
+        if (v.cursor >= v.clip->frames) v.clip = nullptr;
+        else active++;
+    }
+    counters.activeVoices.store(active, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < samples; ++i) {
+        float s = out[i] * masterVolume;
+        out[i] = s < -1.0f ? -1.0f : (s > 1.0f ? 1.0f : s);
+    }
+
+    int micros = (int)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    counters.mixMicros.store(micros, std::memory_order_relaxed);
+    if (micros > counters.mixMicrosMax.load(std::memory_order_relaxed)) {
+        counters.mixMicrosMax.store(micros, std::memory_order_relaxed);
+    }
+}
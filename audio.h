@@ -0,0 +1,131 @@
+#pragma once
+
+#include "raylib.h"
+#include "events.h"
+#include "spsc.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------
+// Audio mixer
+//
+// All sound effects are mixed into one raylib AudioStream whose callback
+// runs on the audio device's thread. The game thread never touches a
+// voice directly: it pushes play / stop / volume commands into an SPSC
+// queue, and the callback drains the queue before mixing each buffer.
+// Clips are decoded up front into the mixer's own format, so the
+// callback only ever adds floats.
+//
+// The music track stays compressed in memory and plays as a raylib
+// Music stream of its own. A music thread calls UpdateMusicStream, which
+// decodes the next buffer's worth whenever raylib has played one, so the
+// track is never decoded whole and the mixer callback never decodes.
+// The game thread steers it through atomics (play / pause, gain).
+// ---------------------------------------------------------
+
+static const int MIXER_SAMPLE_RATE = 44100;
+static const int MIXER_CHANNELS = 2;          // interleaved 32-bit float
+static const int MIXER_VOICES = 32;
+static const int MIXER_QUEUE_SIZE = 256;
+static const int MUSIC_BUFFER_FRAMES = 8192;  // per stream sub-buffer, ~0.19 s
+static const int MUSIC_UPDATE_MS = 20;        // music thread refill interval
+
+enum class AudioOp : uint8_t { PLAY, STOP, VOLUME, MASTER_VOLUME };
+
+struct AudioCommand {
+    AudioOp op;
+    uint8_t voice;   // PLAY / STOP / VOLUME
+    uint8_t sound;   // PLAY: Sfx
+    float volume;    // PLAY, VOLUME and MASTER_VOLUME
+};
+
+// Read from the game thread; written by the callback
+struct AudioCounters {
+    std::atomic<int> queueDepth{ 0 };      // commands waiting at the last callback
+    std::atomic<int> queueHigh{ 0 };       // most ever waiting
+    std::atomic<int> queueFull{ 0 };       // pushes refused (game thread)
+    std::atomic<int> mixMicros{ 0 };       // last callback
+    std::atomic<int> mixMicrosMax{ 0 };    // worst since the last ResetPeak
+    std::atomic<int> activeVoices{ 0 };
+};
+
+struct AudioMixer {
+    AudioMixer() = default;
+    ~AudioMixer() { Shutdown(); }
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    // Before Start: copies the samples, converting to the mixer format
+    void SetSound(Sfx s, const Wave& wave);
+
+    // Before Start: copies the compressed OGG file, decoded while it plays
+    void SetMusic(const void* oggData, size_t size);
+
+    // Clip length in seconds (0 when missing)
+    float SoundLength(Sfx s) const;
+
+    // Opens the stream and starts the music thread; needs the audio device
+    void Start();
+    void Shutdown();
+
+    // Game thread only. Commands are dropped (and counted) when the
+    // queue is full, and ignored before Start. Play says whether the
+    // command was queued.
+    bool Play(int voice, Sfx s, float volume = 1.0f);
+    void Stop(int voice);
+    void SetVoiceVolume(int voice, float volume);
+    // Music resumes / pauses in place; it loops forever
+    void PlayMusic(float volume = 1.0f);
+    void StopMusic();
+    void SetMusicVolume(float volume);
+    void SetMasterVolume(float volume);
+
+    AudioCounters counters;
+
+    void ResetPeak() { counters.mixMicrosMax.store(0, std::memory_order_relaxed); }
+
+private:
+    struct Clip {
+        std::vector<float> samples;   // interleaved stereo
+        uint32_t frames = 0;
+    };
+
+    struct Voice {
+        const Clip* clip = nullptr;   // nullptr = idle
+        uint32_t cursor = 0;
+        float volume = 1.0f;
+    };
+
+    static void Callback(void* buffer, unsigned int frames);
+    void Mix(float* out, unsigned int frames);
+    void Apply(const AudioCommand& cmd);
+    bool Send(const AudioCommand& cmd);
+    static void CopyClip(Clip& clip, const Wave& wave);
+    void MusicThread();
+    void UpdateMusicGain();
+
+    Clip sounds[SOUND_COUNT];
+    std::vector<unsigned char> musicData;   // compressed; the stream reads it in place
+
+    // Audio thread only once started
+    Voice voices[MIXER_VOICES];
+    float masterVolume = 1.0f;
+
+    // Music: the stream belongs to the music thread once started; the
+    // game thread only writes the atomics
+    Music music{};
+    std::thread musicThread;
+    std::atomic<bool> musicRunning{ false };
+    std::atomic<bool> musicPlaying{ false };
+    std::atomic<float> musicGain{ 1.0f };     // music volume x master
+    float musicVolumeSet = 1.0f;              // game thread
+    float masterVolumeSet = 1.0f;
+
+    SpscQueue<AudioCommand, MIXER_QUEUE_SIZE> queue;
+    AudioStream stream{};
+    bool started = false;
+};
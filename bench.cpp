@@ -0,0 +1,351 @@
+// Simulation microbenchmarks (no window required).
+//
+// Build (MinGW):
+//   g++ bench.cpp sim.cpp enemies.cpp broadphase.cpp jobs.cpp drawlist.cpp profiler.cpp trace.cpp -o bench.exe -O2 -Iraylib/include -Lraylib/lib -lraylib -lopengl32 -lgdi32 -lwinmm
+//
+// Every case runs at 10, 100, 1k, 10k and 100k entities and reports
+// ns per op (one call of the case), ns per entity, entities per second
+// and heap allocations per op (counted by profiler.cpp's operator new).
+//   bench [--json [out.json]] [--filter name] [--max N] [--min-time seconds] [--threads N]
+// --json writes bench.json by default, for tracking results per commit.
+// Exits non-zero if the SIMD chase kernel disagrees with the scalar one.
+
+#include "raylib.h"
+#include "sim.h"
+#include "drawlist.h"
+#include "profiler.h"
+#include <vector>
+#include <string>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int ENTITY_COUNTS[] = { 10, 100, 1000, 10000, 100000 };
+static const double DEFAULT_MIN_SECONDS = 0.2;
+static const int SHOT_COUNT = 64;                  // projectiles per collision op
+static const float SORT_MARGIN = 40.0f;            // same band as the game's draw list
+
+static const CharacterClass KNIGHT = { "Knight", 170, 180.0f, 20, RED, PlayerClass::KNIGHT };
+static const CharacterClass MAGE = { "Mage", 90, 190.0f, 10, PURPLE, PlayerClass::MAGE };
+
+// ---------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------
+
+static double NowSeconds() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Same distribution as a horde run: anywhere on the level, anywhere in the lane
+static void FillEnemies(EnemyPool& pool, int count, SimRng& rng) {
+    pool.Clear();
+    for (int i = 0; i < count; ++i) {
+        float x = (float)rng.Range(0, (int)LEVEL_LENGTH);
+        float y = (float)rng.Range((int)GROUND_TOP, (int)GROUND_BOTTOM);
+        pool.Spawn((EnemyType)rng.Range(0, 3), x, y);
+    }
+}
+
+static Vector2 LaneCenter() {
+    return { LEVEL_LENGTH * 0.5f, (GROUND_TOP + GROUND_BOTTOM) * 0.5f };
+}
+
+struct BenchResult {
+    std::string name;
+    int entities;
+    long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+struct BenchOptions {
+    double minSeconds = DEFAULT_MIN_SECONDS;
+    int maxEntities = 100000;
+    int threads = 0;
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+};
+
+static BenchOptions options;
+static std::vector<BenchResult> results;
+
+static bool Selected(const char* name) {
+    return options.filter == nullptr || strstr(name, options.filter) != nullptr;
+}
+
+// Runs fn in growing batches until a batch takes minSeconds, then
+// records that batch. One untimed call first warms caches and buffers.
+template <typename Fn>
+static void Measure(const char* name, int entities, Fn&& fn) {
+    fn();
+
+    long long iterations = 1;
+    for (;;) {
+        uint64_t allocs0 = AllocationCount();
+        uint64_t bytes0 = AllocationBytes();
+        double t0 = NowSeconds();
+        for (long long r = 0; r < iterations; ++r) fn();
+        double elapsed = NowSeconds() - t0;
+
+        if (elapsed >= options.minSeconds) {
+            BenchResult res;
+            res.name = name;
+            res.entities = entities;
+            res.iterations = iterations;
+            res.nsPerOp = elapsed * 1e9 / (double)iterations;
+            res.allocsPerOp = (double)(AllocationCount() - allocs0) / (double)iterations;
+            res.bytesPerOp = (double)(AllocationBytes() - bytes0) / (double)iterations;
+            results.push_back(res);
+
+            printf("  %-22s %8d %10lld %14.1f %12.2f %14.3g %10.2f\n",
+                   name, entities, iterations, res.nsPerOp, res.nsPerOp / entities,
+                   entities * 1e9 / res.nsPerOp, res.allocsPerOp);
+            fflush(stdout);
+            return;
+        }
+
+        // Aim a little past the target so the next batch usually lands
+        long long next = elapsed > 0.0 ? (long long)(iterations * options.minSeconds * 1.2 / elapsed) : iterations * 10;
+        iterations = next > iterations * 2 ? next : iterations * 2;
+    }
+}
+
+// Calls body(n) for each entity count up to --max
+template <typename Fn>
+static void ForEachCount(const char* name, Fn&& body) {
+    if (!Selected(name)) return;
+    for (int n : ENTITY_COUNTS) {
+        if (n <= options.maxEntities) body(n);
+    }
+}
+
+// ---------------------------------------------------------
+// Cases
+// ---------------------------------------------------------
+
+// Melee hitbox against every enemy rect, no broadphase
+static void BenchRectOverlap() {
+    ForEachCount("rect_overlap", [](int n) {
+        SimRng rng;
+        EnemyPool pool;
+        pool.Init(n);
+        FillEnemies(pool, n, rng);
+        const Rectangle hitbox = MakeRect(LaneCenter(), { 90.0f, 75.0f });
+
+        volatile int sink = 0;
+        Measure("rect_overlap", n, [&]() {
+            int hits = 0;
+            for (int i = 0; i < pool.count; ++i) {
+                if (RectOverlap(hitbox, MakeRect(pool.Pos(i), pool.Size(i)))) hits++;
+            }
+            sink = hits;
+        });
+    });
+}
+
+// Some enemies mid-attack so the mask path is exercised
+static void BenchChase(const char* name, void (*step)(EnemyPool&, int, int, Vector2, float)) {
+    ForEachCount(name, [&](int n) {
+        SimRng rng;
+        EnemyPool pool;
+        pool.Init(n);
+        FillEnemies(pool, n, rng);
+        for (int i = 0; i < n; i += 7) pool.flags[i] |= ENEMY_WINDING_UP;
+        for (int i = 3; i < n; i += 11) pool.flags[i] |= ENEMY_ATTACKING;
+
+        const Vector2 target = LaneCenter();
+        const float dt = 1.0f / 120.0f;
+        Measure(name, n, [&]() { step(pool, 0, n, target, dt); });
+    });
+}
+
+// One tick of mage bolts against the enemy grid, as the sim does it:
+// rebuild the grid, then SimWorld::CollideProjectiles. Bolt ids change
+// every op so enemies already hit keep counting as hits.
+static void BenchProjectileCollision() {
+    ForEachCount("projectile_collision", [](int n) {
+        SimWorld world(n);
+        SimRng rng;
+        FillEnemies(world.enemies, n, rng);
+        for (int s = 0; s < SHOT_COUNT; ++s) {
+            Projectile& p = *world.projectiles.Add();
+            p.pos = { (float)rng.Range(0, (int)LEVEL_LENGTH), (float)rng.Range((int)GROUND_TOP, (int)GROUND_BOTTOM) - 25.0f };
+            p.prevPos = p.pos;
+            p.vel = { 0.0f, 0.0f };
+            p.radius = 22.0f;
+            p.life = 1.0f;
+            p.damage = 10;
+        }
+
+        int nextId = 1;
+        EnemyPool& en = world.enemies;
+        Measure("projectile_collision", n, [&]() {
+            for (auto& p : world.projectiles) p.id = nextId++;
+            world.events.hits.clear();
+            world.enemyGrid.Build(en.posX.data(), en.sizeX.data(), en.count);
+            world.CollideProjectiles();
+        });
+    });
+}
+
+// Coins scattered along the lane with every 16th under the player; the
+// pool is restored each op so the pickups repeat (the copy is included).
+static void BenchCoinPickup() {
+    ForEachCount("coin_pickup", [](int n) {
+        SimWorld world;
+        world.Reset(KNIGHT);
+        world.coins.Init(n);
+
+        SimRng rng;
+        for (int i = 0; i < n; ++i) {
+            Coin& c = *world.coins.Add();
+            c.pos = (i % 16 == 0) ? world.player.pos
+                                  : Vector2{ (float)rng.Range(0, (int)LEVEL_LENGTH), (float)rng.Range((int)GROUND_TOP, (int)GROUND_BOTTOM) };
+            c.life = COIN_LIFETIME;
+        }
+        const std::vector<Coin> snapshot = world.coins.items;
+
+        Measure("coin_pickup", n, [&]() {
+            world.coins.items = snapshot;
+            world.coins.count = n;
+            world.UpdateCoins(1.0f / 120.0f);
+        });
+    });
+}
+
+// Cull-free draw list build: every enemy added by ground y, then sorted
+static void BenchYSort() {
+    ForEachCount("y_sort", [](int n) {
+        SimRng rng;
+        EnemyPool pool;
+        pool.Init(n);
+        FillEnemies(pool, n, rng);
+
+        DrawList list;
+        list.Init(n, GROUND_TOP - SORT_MARGIN, GROUND_BOTTOM + SORT_MARGIN);
+        Measure("y_sort", n, [&]() {
+            list.Clear();
+            for (int i = 0; i < pool.count; ++i) list.Add(DrawKind::ENEMY, i, pool.posY[i]);
+            list.Sort();
+        });
+    });
+}
+
+// Full fixed ticks with a horde. The player stands still swinging and
+// nobody can die, so the run never ends and the horde keeps its size
+// while it closes in.
+static void BenchStep(const char* name, const CharacterClass& cc) {
+    ForEachCount(name, [&](int n) {
+        JobPool jobs(options.threads);
+        SimWorld world(n + 64);
+        if (options.threads > 0) world.jobs = &jobs;
+        world.Reset(cc);
+        world.player.maxHP = world.player.hp = INT_MAX / 2;
+
+        for (int i = 0; i < n; ++i) {
+            float x = (float)world.rng.Range(400, (int)LEVEL_LENGTH - 300);
+            float laneY = (float)world.rng.Range((int)GROUND_TOP, (int)GROUND_BOTTOM);
+            int e = world.enemies.Spawn(RollEnemyType(world.rng), x, laneY);
+            if (e < 0) break;
+            world.enemies.hp[e] = INT_MAX / 2;
+        }
+
+        const float dt = 1.0f / 120.0f;
+        Measure(name, n, [&]() {
+            InputFrame in;
+            in.attackPressed = (world.tick % 12) == 0;
+            world.Step(in, dt);
+        });
+    });
+}
+
+// The SIMD kernel must match the scalar loop exactly
+static bool CheckChaseKernels() {
+    SimRng rng;
+    EnemyPool scalarPool;
+    scalarPool.Init(1000);
+    FillEnemies(scalarPool, 1000, rng);
+    for (int i = 0; i < 1000; i += 7) scalarPool.flags[i] |= ENEMY_WINDING_UP;
+    EnemyPool simdPool = scalarPool;
+
+    for (int t = 0; t < 100; ++t) {
+        ChaseStepScalar(scalarPool, 0, scalarPool.count, LaneCenter(), 1.0f / 120.0f);
+        ChaseStep(simdPool, 0, simdPool.count, LaneCenter(), 1.0f / 120.0f);
+    }
+    return scalarPool.posX == simdPool.posX && scalarPool.posY == simdPool.posY;
+}
+
+// ---------------------------------------------------------
+// Output
+// ---------------------------------------------------------
+
+static bool WriteJson(const char* path, bool chaseMatches) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "bench: cannot write %s\n", path);
+        return false;
+    }
+
+    fprintf(f, "{\n  \"chase_kernel\": \"%s\",\n  \"chase_kernel_matches\": %s,\n  \"threads\": %d,\n"
+               "  \"min_seconds\": %g,\n  \"results\": [",
+            ChaseKernelName(), chaseMatches ? "true" : "false", options.threads, options.minSeconds);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"entities\": %d, \"iterations\": %lld, "
+                   "\"ns_per_op\": %.3f, \"ns_per_entity\": %.4f, \"entities_per_sec\": %.1f, "
+                   "\"allocs_per_op\": %.4f, \"alloc_bytes_per_op\": %.1f}",
+                i ? "," : "", r.name.c_str(), r.entities, r.iterations,
+                r.nsPerOp, r.nsPerOp / r.entities, r.entities * 1e9 / r.nsPerOp,
+                r.allocsPerOp, r.bytesPerOp);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+    printf("bench: wrote %d results to %s\n", (int)results.size(), path);
+    return true;
+}
+
+// ---------------------------------------------------------
+// Main
+// ---------------------------------------------------------
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0) {
+            options.jsonPath = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "bench.json";
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+            options.maxEntities = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "bench: unknown argument %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    printf("chase kernel: %s, step threads: %d\n", ChaseKernelName(), options.threads);
+    // A mismatch still runs the cases, but fails the run
+    const bool chaseMatches = CheckChaseKernels();
+    if (!chaseMatches) printf("  (CHASE RESULT MISMATCH: %s differs from scalar)\n", ChaseKernelName());
+    printf("  %-22s %8s %10s %14s %12s %14s %10s\n",
+           "case", "entities", "iters", "ns/op", "ns/entity", "entities/s", "allocs/op");
+
+    BenchRectOverlap();
+    BenchChase("chase_step", ChaseStep);
+    BenchChase("chase_step_scalar", ChaseStepScalar);
+    BenchProjectileCollision();
+    BenchCoinPickup();
+    BenchYSort();
+    BenchStep("step_knight", KNIGHT);
+    BenchStep("step_mage", MAGE);
+
+    if (options.jsonPath && !WriteJson(options.jsonPath, chaseMatches)) return 1;
+    return chaseMatches ? 0 : 1;
+}
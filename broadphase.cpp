@@ -0,0 +1,45 @@
+#include "broadphase.h"
+
+void BroadphaseX::Init(float rangeMinX, float rangeMaxX, float cell) {
+    minX = rangeMinX;
+    cellSize = cell;
+    invCellSize = 1.0f / cell;
+    cellCount = (int)((rangeMaxX - rangeMinX) * invCellSize) + 1;
+    cellStart.assign(cellCount + 1, 0);
+    items.clear();
+    cellOf.clear();
+    maxHalfWidth = 0.0f;
+}
+
+void BroadphaseX::Build(const float* centerX, const float* width, int count) {
+    if ((int)items.size() < count) {
+        items.resize(count);
+        cellOf.resize(count);
+    }
+
+    // Count per cell (shifted by one so the prefix sum yields starts)
+    for (int c = 0; c <= cellCount; ++c) cellStart[c] = 0;
+
+    float widest = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        int c = CellIndex(centerX[i]);
+        cellOf[i] = c;
+        cellStart[c + 1]++;
+        if (width[i] > widest) widest = width[i];
+    }
+    maxHalfWidth = widest * 0.5f;
+
+    for (int c = 0; c < cellCount; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    // Scatter; cellStart[c] is used as the write cursor and ends up at
+    // the start of cell c + 1, so shift back afterwards
+    for (int i = 0; i < count; ++i) {
+        items[cellStart[cellOf[i]]++] = i;
+    }
+    for (int c = cellCount; c > 0; --c) {
+        cellStart[c] = cellStart[c - 1];
+    }
+    cellStart[0] = 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+// ---------------------------------------------------------
+// 1D bucket grid along x
+//
+// The play field is a thin lane along a long x axis, so bucketing by
+// x alone culls almost everything. Build() is a counting sort of
+// entity indices by cell (O(n), no allocation once warmed up); queries
+// visit only the cells a range touches, in cell order, and within a
+// cell in index order, so results are deterministic.
+//
+// Entities are binned by their center. Queries are widened by half the
+// largest width seen in Build() so wide entities (the boss) are never
+// missed.
+// ---------------------------------------------------------
+
+struct BroadphaseX {
+    float minX = 0.0f;
+    float cellSize = 64.0f;
+    float invCellSize = 1.0f / 64.0f;
+    int cellCount = 0;
+    float maxHalfWidth = 0.0f;
+
+    std::vector<int> cellStart;   // cellCount + 1 offsets into items
+    std::vector<int> items;       // entity indices grouped by cell
+    std::vector<int> cellOf;      // scratch: cell of each entity
+
+    void Init(float rangeMinX, float rangeMaxX, float cell);
+
+    void Build(const float* centerX, const float* width, int count);
+
+    int CellIndex(float x) const {
+        float f = (x - minX) * invCellSize;
+        if (f < 0.0f) return 0;
+        if (f >= (float)cellCount) return cellCount - 1;
+        return (int)f;
+    }
+
+    // Calls fn(index) for every entity whose center lies in a cell that
+    // could overlap [x0, x1]. Callers still do the exact test.
+    template <typename Fn>
+    void ForEachInRange(float x0, float x1, Fn&& fn) const {
+        if (cellCount == 0) return;
+        int c0 = CellIndex(x0 - maxHalfWidth);
+        int c1 = CellIndex(x1 + maxHalfWidth);
+        for (int i = cellStart[c0]; i < cellStart[c1 + 1]; ++i) {
+            fn(items[i]);
+        }
+    }
+};
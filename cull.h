@@ -0,0 +1,51 @@
+#pragma once
+
+#include "raylib.h"
+
+// ---------------------------------------------------------
+// View culling
+//
+// World draws are tested against the camera's visible rect before they
+// go into the draw list. A test takes the entity's anchor (its feet)
+// and how far its pixels reach from there - scaled sprite, shadow, HP
+// bar - so nothing pops in or out at the screen edge.
+// ---------------------------------------------------------
+
+struct CullExtents {
+    float halfWidth;   // either side of anchor.x
+    float above;       // up from anchor.y
+    float below;       // down from anchor.y (shadows)
+};
+
+struct ViewCuller {
+    Rectangle view{};
+    int drawn = 0;
+    int culled = 0;
+
+    // Visible world rect for this frame; resets the counters
+    void Begin(const Camera2D& camera, int screenWidth, int screenHeight) {
+        float w = screenWidth / camera.zoom;
+        float h = screenHeight / camera.zoom;
+        view = { camera.target.x - camera.offset.x / camera.zoom,
+                 camera.target.y - camera.offset.y / camera.zoom, w, h };
+        drawn = 0;
+        culled = 0;
+    }
+
+    bool Test(Vector2 anchor, const CullExtents& e) {
+        bool visible = anchor.x + e.halfWidth >= view.x &&
+                       anchor.x - e.halfWidth <= view.x + view.width &&
+                       anchor.y + e.below >= view.y &&
+                       anchor.y - e.above <= view.y + view.height;
+        if (visible) drawn++;
+        else culled++;
+        return visible;
+    }
+
+    // Clips [x0, x1) to the view; false when nothing is left
+    bool ClipSpanX(float& x0, float& x1) const {
+        if (x0 < view.x) x0 = view.x;
+        if (x1 > view.x + view.width) x1 = view.x + view.width;
+        return x1 > x0;
+    }
+};
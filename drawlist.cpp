@@ -0,0 +1,40 @@
+#include "drawlist.h"
+#include <cmath>
+
+void DrawList::Init(int maxItems, float lo, float hi) {
+    minY = lo;
+    bucketScale = (float)DRAW_BUCKETS_PER_PIXEL;
+    int buckets = (int)std::ceil((hi - lo) * bucketScale) + 1;
+
+    items.assign(maxItems, DrawItem{});
+    keys.assign(maxItems, 0);
+    sorted.assign(maxItems, DrawItem{});
+    offsets.assign(buckets + 1, 0);
+    count = 0;
+}
+
+void DrawList::Add(DrawKind kind, int index, float y) {
+    if (count >= (int)items.size()) return;
+
+    int buckets = (int)offsets.size() - 1;
+    int key = (int)((y - minY) * bucketScale);
+    if (key < 0) key = 0;
+    if (key >= buckets) key = buckets - 1;
+
+    items[count] = { kind, index };
+    keys[count] = (uint16_t)key;
+    count++;
+}
+
+void DrawList::Sort() {
+    int buckets = (int)offsets.size() - 1;
+    for (int b = 0; b <= buckets; ++b) offsets[b] = 0;
+
+    // Histogram, then exclusive prefix sum gives each bucket's start
+    for (int i = 0; i < count; ++i) offsets[keys[i] + 1]++;
+    for (int b = 0; b < buckets; ++b) offsets[b + 1] += offsets[b];
+
+    for (int i = 0; i < count; ++i) {
+        sorted[offsets[keys[i]]++] = items[i];
+    }
+}
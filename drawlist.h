@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// ---------------------------------------------------------
+// Y-sorted draw list
+//
+// Everything in the lane is drawn back to front by its ground y. All
+// keys fall in a narrow band around GROUND_TOP..GROUND_BOTTOM, so they
+// are quantized into buckets and ordered with a stable counting sort:
+// O(n) per frame, and every buffer is sized once in Init.
+// ---------------------------------------------------------
+
+enum class DrawKind : uint8_t { PLAYER, ENEMY, COIN, PROJECTILE };
+
+struct DrawItem {
+    DrawKind kind;
+    int index;      // dense index into the matching pool (unused for PLAYER)
+};
+
+static const int DRAW_BUCKETS_PER_PIXEL = 4;
+
+struct DrawList {
+    // Keys outside [minY, maxY] are clamped to the first / last bucket
+    void Init(int maxItems, float minY, float maxY);
+
+    void Clear() { count = 0; }
+    void Add(DrawKind kind, int index, float y);
+
+    // Stable: equal keys keep their Add order
+    void Sort();
+
+    int Size() const { return count; }
+    const DrawItem* begin() const { return sorted.data(); }
+    const DrawItem* end() const { return sorted.data() + count; }
+
+private:
+    float minY = 0.0f;
+    float bucketScale = 1.0f;
+    int count = 0;
+
+    std::vector<DrawItem> items;
+    std::vector<uint16_t> keys;
+    std::vector<DrawItem> sorted;
+    std::vector<int> offsets;   // one per bucket, +1
+};
@@ -0,0 +1,335 @@
+#include "enemies.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CHASE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHASE_SSE2 1
+#endif
+
+// ---------------------------------------------------------
+// Archetypes
+// ---------------------------------------------------------
+
+EnemyArchetype enemyArchetypes[ENEMY_TYPE_COUNT] = {
+    DEFAULT_ENEMY_ARCHETYPES[0],
+    DEFAULT_ENEMY_ARCHETYPES[1],
+    DEFAULT_ENEMY_ARCHETYPES[2],
+    DEFAULT_ENEMY_ARCHETYPES[3],
+};
+static_assert(ENEMY_TYPE_COUNT == 4, "add the new type to enemyArchetypes");
+
+bool LoadEnemyArchetypes(const char* path, EnemyArchetype table[ENEMY_TYPE_COUNT]) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    char line[256];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        char* s = line;
+        while (*s == ' ' || *s == '\t') s++;
+        if (*s == '#' || *s == '\n' || *s == '\r' || *s == '\0') continue;
+
+        // name w h hp speed windup damage coins weight r g b sprite
+        char name[32];
+        EnemyArchetype a{};
+        int r, g, b;
+        int n = sscanf(s, "%31s %f %f %d %f %f %d %d %d %d %d %d %63s",
+                       name, &a.sizeX, &a.sizeY, &a.hp, &a.speed, &a.windup,
+                       &a.damage, &a.coins, &a.spawnWeight, &r, &g, &b, a.sprite);
+        if (n != 13) {
+            fprintf(stderr, "%s:%d: expected 13 columns, got %d\n", path, lineNo, n);
+            continue;
+        }
+
+        // A bad value would break spawns, the broadphase or the spawn
+        // roll, so the row is dropped and the default kept
+        const char* bad = nullptr;
+        if (!(a.sizeX > 0.0f) || !(a.sizeY > 0.0f)) bad = "size must be positive";
+        else if (a.hp <= 0) bad = "hp must be positive";
+        else if (!(a.speed >= 0.0f) || !(a.windup >= 0.0f)) bad = "speed and windup can't be negative";
+        else if (a.damage < 0 || a.coins < 0) bad = "damage and coins can't be negative";
+        else if (a.spawnWeight < 0) bad = "spawn weight can't be negative";
+        else if (r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255) bad = "colour channels must be 0..255";
+        if (bad) {
+            fprintf(stderr, "%s:%d: %s\n", path, lineNo, bad);
+            continue;
+        }
+
+        int t = 0;
+        while (t < ENEMY_TYPE_COUNT && strcmp(name, table[t].name) != 0) t++;
+        if (t == ENEMY_TYPE_COUNT) {
+            fprintf(stderr, "%s:%d: unknown enemy type '%s'\n", path, lineNo, name);
+            continue;
+        }
+
+        a.name = table[t].name;
+        a.tint = { (unsigned char)r, (unsigned char)g, (unsigned char)b, 255 };
+        table[t] = a;
+    }
+
+    fclose(f);
+    return true;
+}
+
+// ---------------------------------------------------------
+// Pool
+// ---------------------------------------------------------
+
+void EnemyPool::Init(int maxCount) {
+    capacity = maxCount;
+    count = 0;
+
+    posX.assign(capacity, 0.0f);
+    posY.assign(capacity, 0.0f);
+    sizeX.assign(capacity, 0.0f);
+    sizeY.assign(capacity, 0.0f);
+    speed.assign(capacity, 0.0f);
+    hp.assign(capacity, 0);
+    attackCooldown.assign(capacity, 0.0f);
+    windupTimer.assign(capacity, 0.0f);
+    attackAnimTimer.assign(capacity, 0.0f);
+    flags.assign(capacity, 0u);
+    lastHitAttackId.assign(capacity, -1);
+    lastProjectileHitId.assign(capacity, -1);
+
+    type.assign(capacity, EnemyType::GRUNT);
+    maxHP.assign(capacity, 0);
+    prevX.assign(capacity, 0.0f);
+    prevY.assign(capacity, 0.0f);
+    animFrame.assign(capacity, 0);
+    animRow.assign(capacity, 0);
+    animTimer.assign(capacity, 0.0f);
+
+    Clear();
+}
+
+void EnemyPool::Clear() {
+    count = 0;
+}
+
+int EnemyPool::Spawn(EnemyType t, float x, float laneY) {
+    if (count >= capacity) return -1;
+
+    int i = count++;
+
+    type[i] = t;
+    posX[i] = prevX[i] = x;
+    posY[i] = prevY[i] = laneY;
+
+    const EnemyArchetype& a = Archetype(t);
+    sizeX[i] = a.sizeX;
+    sizeY[i] = a.sizeY;
+    maxHP[i] = hp[i] = a.hp;
+    speed[i] = a.speed;
+
+    attackCooldown[i] = 0.0f;
+    windupTimer[i] = 0.0f;
+    attackAnimTimer[i] = 0.0f;
+    flags[i] = 0u;
+    lastHitAttackId[i] = -1;
+    lastProjectileHitId[i] = -1;
+
+    animFrame[i] = 0;
+    animRow[i] = 0;
+    animTimer[i] = 0.0f;
+    return i;
+}
+
+void EnemyPool::MoveSlot(int dst, int src) {
+    posX[dst] = posX[src];
+    posY[dst] = posY[src];
+    sizeX[dst] = sizeX[src];
+    sizeY[dst] = sizeY[src];
+    speed[dst] = speed[src];
+    hp[dst] = hp[src];
+    attackCooldown[dst] = attackCooldown[src];
+    windupTimer[dst] = windupTimer[src];
+    attackAnimTimer[dst] = attackAnimTimer[src];
+    flags[dst] = flags[src];
+    lastHitAttackId[dst] = lastHitAttackId[src];
+    lastProjectileHitId[dst] = lastProjectileHitId[src];
+
+    type[dst] = type[src];
+    maxHP[dst] = maxHP[src];
+    prevX[dst] = prevX[src];
+    prevY[dst] = prevY[src];
+    animFrame[dst] = animFrame[src];
+    animRow[dst] = animRow[src];
+    animTimer[dst] = animTimer[src];
+}
+
+void EnemyPool::Compact() {
+    int i = 0;
+    while (i < count) {
+        if (!(flags[i] & ENEMY_DEAD)) {
+            ++i;
+            continue;
+        }
+        int last = --count;
+        if (i != last) MoveSlot(i, last);
+        // re-check slot i: it now holds what was the last enemy
+    }
+}
+
+// ---------------------------------------------------------
+// Chase movement
+// ---------------------------------------------------------
+
+static const uint32_t CHASE_BLOCKED = ENEMY_WINDING_UP | ENEMY_ATTACKING;
+
+void ChaseStepScalar(EnemyPool& pool, int begin, int end, Vector2 target, float dt) {
+    float* px = pool.posX.data();
+    float* py = pool.posY.data();
+    const float* speed = pool.speed.data();
+    const uint32_t* flags = pool.flags.data();
+
+    for (int i = begin; i < end; ++i) {
+        if (flags[i] & CHASE_BLOCKED) continue;
+
+        float dx = target.x - px[i];
+        float dy = target.y - py[i];
+        float dist = std::sqrt(dx * dx + dy * dy);
+        if (dist > ENEMY_STOP_DISTANCE) {
+            dx /= dist;
+            dy /= dist;
+        } else {
+            dx = 0.0f;
+            dy = 0.0f;
+        }
+
+        px[i] += dx * speed[i] * dt;
+        float y = py[i] + dy * speed[i] * ENEMY_VERTICAL_SPEED * dt;
+
+        if (y < GROUND_TOP) y = GROUND_TOP;
+        if (y > GROUND_BOTTOM) y = GROUND_BOTTOM;
+        py[i] = y;
+    }
+}
+
+#if defined(CHASE_AVX2)
+
+void ChaseStep(EnemyPool& pool, int begin, int end, Vector2 target, float dt) {
+    float* px = pool.posX.data();
+    float* py = pool.posY.data();
+    const float* speed = pool.speed.data();
+    const uint32_t* flags = pool.flags.data();
+
+    const __m256 tx = _mm256_set1_ps(target.x);
+    const __m256 ty = _mm256_set1_ps(target.y);
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vert = _mm256_set1_ps(ENEMY_VERTICAL_SPEED);
+    const __m256 stop = _mm256_set1_ps(ENEMY_STOP_DISTANCE);
+    const __m256 top = _mm256_set1_ps(GROUND_TOP);
+    const __m256 bottom = _mm256_set1_ps(GROUND_BOTTOM);
+    const __m256i blocked = _mm256_set1_epi32((int)CHASE_BLOCKED);
+    const __m256i zero = _mm256_setzero_si256();
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 x = _mm256_loadu_ps(px + i);
+        __m256 y = _mm256_loadu_ps(py + i);
+        __m256 spd = _mm256_loadu_ps(speed + i);
+        __m256i fl = _mm256_loadu_si256((const __m256i*)(flags + i));
+
+        // Lanes that are free to move
+        __m256 moving = _mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_and_si256(fl, blocked), zero));
+
+        __m256 dx = _mm256_sub_ps(tx, x);
+        __m256 dy = _mm256_sub_ps(ty, y);
+        __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+
+        // Normalize, or zero when already on top of the target
+        __m256 far = _mm256_cmp_ps(dist, stop, _CMP_GT_OQ);
+        dx = _mm256_and_ps(far, _mm256_div_ps(dx, dist));
+        dy = _mm256_and_ps(far, _mm256_div_ps(dy, dist));
+
+        __m256 stepX = _mm256_mul_ps(_mm256_mul_ps(dx, spd), vdt);
+        __m256 stepY = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(dy, spd), vert), vdt);
+
+        __m256 nx = _mm256_add_ps(x, stepX);
+        __m256 ny = _mm256_add_ps(y, stepY);
+        ny = _mm256_min_ps(_mm256_max_ps(ny, top), bottom);
+
+        _mm256_storeu_ps(px + i, _mm256_blendv_ps(x, nx, moving));
+        _mm256_storeu_ps(py + i, _mm256_blendv_ps(y, ny, moving));
+    }
+
+    ChaseStepScalar(pool, i, end, target, dt);
+}
+
+const char* ChaseKernelName() { return "avx2"; }
+
+#elif defined(CHASE_SSE2)
+
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+    // mask ? b : a (SSE2 has no blendv)
+    return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+}
+
+void ChaseStep(EnemyPool& pool, int begin, int end, Vector2 target, float dt) {
+    float* px = pool.posX.data();
+    float* py = pool.posY.data();
+    const float* speed = pool.speed.data();
+    const uint32_t* flags = pool.flags.data();
+
+    const __m128 tx = _mm_set1_ps(target.x);
+    const __m128 ty = _mm_set1_ps(target.y);
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vert = _mm_set1_ps(ENEMY_VERTICAL_SPEED);
+    const __m128 stop = _mm_set1_ps(ENEMY_STOP_DISTANCE);
+    const __m128 top = _mm_set1_ps(GROUND_TOP);
+    const __m128 bottom = _mm_set1_ps(GROUND_BOTTOM);
+    const __m128i blocked = _mm_set1_epi32((int)CHASE_BLOCKED);
+    const __m128i zero = _mm_setzero_si128();
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(px + i);
+        __m128 y = _mm_loadu_ps(py + i);
+        __m128 spd = _mm_loadu_ps(speed + i);
+        __m128i fl = _mm_loadu_si128((const __m128i*)(flags + i));
+
+        // Lanes that are free to move
+        __m128 moving = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(fl, blocked), zero));
+
+        __m128 dx = _mm_sub_ps(tx, x);
+        __m128 dy = _mm_sub_ps(ty, y);
+        __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+        // Normalize, or zero when already on top of the target
+        __m128 far = _mm_cmpgt_ps(dist, stop);
+        dx = _mm_and_ps(far, _mm_div_ps(dx, dist));
+        dy = _mm_and_ps(far, _mm_div_ps(dy, dist));
+
+        __m128 stepX = _mm_mul_ps(_mm_mul_ps(dx, spd), vdt);
+        __m128 stepY = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(dy, spd), vert), vdt);
+
+        __m128 nx = _mm_add_ps(x, stepX);
+        __m128 ny = _mm_add_ps(y, stepY);
+        ny = _mm_min_ps(_mm_max_ps(ny, top), bottom);
+
+        _mm_storeu_ps(px + i, Select(moving, x, nx));
+        _mm_storeu_ps(py + i, Select(moving, y, ny));
+    }
+
+    ChaseStepScalar(pool, i, end, target, dt);
+}
+
+const char* ChaseKernelName() { return "sse2"; }
+
+#else
+
+void ChaseStep(EnemyPool& pool, int begin, int end, Vector2 target, float dt) {
+    ChaseStepScalar(pool, begin, end, target, dt);
+}
+
+const char* ChaseKernelName() { return "scalar"; }
+
+#endif
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "raylib.h"
+#include "level.h"
+#include <vector>
+#include <cstdint>
+
+// ---------------------------------------------------------
+// Enemy pool (struct-of-arrays, dense with swap-remove compaction)
+//
+// Live enemies are always packed in [0, count), so every pass walks
+// only live entries. Killing an enemy just flags it; Compact() at the
+// end of the tick swap-removes the dead ones, which keeps dense
+// indices stable for the whole tick. Nothing refers to an enemy
+// across ticks, so there are no stable handles to maintain.
+// ---------------------------------------------------------
+
+enum class EnemyType { GRUNT, FAST, TANK, BOSS, COUNT };
+
+static const int ENEMY_TYPE_COUNT = (int)EnemyType::COUNT;
+
+const int ENEMY_SPRITE_COLS = 4;
+const int ENEMY_SPRITE_ROWS = 2; // 0 walk, 1 attack
+
+static const int MAX_ENEMIES = 16384;
+static const float ENEMY_ANIM_FRAME_TIME = 0.15f;
+static const float ENEMY_VERTICAL_SPEED = 0.6f;   // enemies close the lane gap slower
+static const float ENEMY_STOP_DISTANCE = 5.0f;
+
+// EnemyPool::flags bits
+enum : uint32_t {
+    ENEMY_WINDING_UP = 1u << 0,
+    ENEMY_ATTACKING  = 1u << 1,   // attack animation after the windup
+    ENEMY_DEAD       = 1u << 2    // waiting for Compact()
+};
+
+// ---------------------------------------------------------
+// Enemy archetypes
+//
+// Everything that differs between enemy types, indexed by EnemyType.
+// The built-in table below is the fallback; LoadEnemyArchetypes can
+// override it from a text file at startup (see data/enemies.txt).
+// ---------------------------------------------------------
+
+static const int ENEMY_SPRITE_PATH_MAX = 64;
+
+struct EnemyArchetype {
+    const char* name;      // key used in the data file
+    float sizeX, sizeY;
+    int hp;
+    float speed;
+    float windup;          // telegraph before the hit lands
+    int damage;
+    int coins;             // dropped on death
+    int spawnWeight;       // regular spawner odds; 0 = never (boss)
+    Color tint;            // placeholder colour when the sprite is missing
+    char sprite[ENEMY_SPRITE_PATH_MAX];
+};
+
+constexpr EnemyArchetype DEFAULT_ENEMY_ARCHETYPES[ENEMY_TYPE_COUNT] = {
+    //  name     size        hp   speed   windup dmg coins weight tint                    sprite
+    { "grunt",   40,  70,    90,  80.0f,  0.35f,  6,  1,   1,     { 230, 41, 55, 255 },   "assets/enemy_grunt.png" },
+    { "fast",    32,  60,    80, 135.0f,  0.25f,  8,  1,   1,     { 255, 161, 0, 255 },   "assets/enemy_fast.png" },
+    { "tank",    60,  90,   150,  55.0f,  0.45f, 13,  3,   1,     { 190, 33, 55, 255 },   "assets/enemy_tank.png" },
+    { "boss",   100, 140,   450,  70.0f,  0.6f,  20, 10,   0,     { 112, 31, 126, 255 },  "assets/enemy_boss.png" },
+};
+
+// Live table, starts as a copy of DEFAULT_ENEMY_ARCHETYPES
+extern EnemyArchetype enemyArchetypes[ENEMY_TYPE_COUNT];
+
+inline const EnemyArchetype& Archetype(EnemyType t) { return enemyArchetypes[(int)t]; }
+
+// Overrides rows of `table` (the live one by default) from a text file.
+// Returns false if the file can't be opened; malformed, out-of-range
+// or unknown rows are reported and skipped, keeping the previous row.
+bool LoadEnemyArchetypes(const char* path, EnemyArchetype table[ENEMY_TYPE_COUNT] = enemyArchetypes);
+
+struct EnemyPool {
+    int capacity = 0;
+    int count = 0;
+
+    // Hot: touched every tick by AI and collision
+    std::vector<float> posX, posY;
+    std::vector<float> sizeX, sizeY;
+    std::vector<float> speed;
+    std::vector<int> hp;
+    std::vector<float> attackCooldown;
+    std::vector<float> windupTimer;
+    std::vector<float> attackAnimTimer;
+    std::vector<uint32_t> flags;
+    std::vector<int> lastHitAttackId;      // for melee
+    std::vector<int> lastProjectileHitId;  // for mage projectiles
+
+    // Cold: spawn data, animation, render interpolation
+    std::vector<EnemyType> type;
+    std::vector<int> maxHP;
+    std::vector<float> prevX, prevY;
+    std::vector<int> animFrame;
+    std::vector<int> animRow;
+    std::vector<float> animTimer;
+
+    // Allocates every array once; nothing grows after this
+    void Init(int maxCount);
+    void Clear();
+
+    // Returns the dense index, or -1 when the pool is full
+    int Spawn(EnemyType t, float x, float laneY);
+
+    void Kill(int i) { flags[i] |= ENEMY_DEAD; }
+    bool IsDead(int i) const { return (flags[i] & ENEMY_DEAD) != 0; }
+
+    // Swap-removes every dead enemy. Invalidates dense indices.
+    void Compact();
+
+    Vector2 Pos(int i) const { return { posX[i], posY[i] }; }
+    Vector2 PrevPos(int i) const { return { prevX[i], prevY[i] }; }
+    Vector2 Size(int i) const { return { sizeX[i], sizeY[i] }; }
+
+private:
+    void MoveSlot(int dst, int src);
+};
+
+// ---------------------------------------------------------
+// Chase movement
+//
+// Moves enemies [begin, end) toward `target` unless they are winding
+// up or attacking, then clamps them to the lane. ChaseStep uses AVX2
+// when compiled with -mavx2, SSE2 otherwise (always on x86-64), and
+// falls back to ChaseStepScalar elsewhere. The flag test is a lane
+// mask instead of a branch. Every path does the same IEEE operations
+// in the same order, so results match the scalar loop.
+// ---------------------------------------------------------
+
+void ChaseStep(EnemyPool& pool, int begin, int end, Vector2 target, float dt);
+void ChaseStepScalar(EnemyPool& pool, int begin, int end, Vector2 target, float dt);
+
+// "avx2", "sse2" or "scalar"
+const char* ChaseKernelName();
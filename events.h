@@ -0,0 +1,73 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+// ---------------------------------------------------------
+// Combat events
+//
+// Collision and AI code never applies damage, drops loot, plays
+// sounds or changes state directly; it appends events here and
+// SimWorld::ResolveCombat drains every queue once per tick, in the
+// order they were produced.
+// ---------------------------------------------------------
+
+enum class GameState { MENU, PLAYING, SHOP, VICTORY, GAMEOVER };
+
+// Sounds the simulation asks the app to play (it never plays them itself)
+enum class Sfx { KNIGHT_SWING, ROGUE_SWING, MAGE_CAST, HIT, ENEMY_SWING, BLOCK, DODGE, BLINK, COUNT };
+
+static const int SOUND_COUNT = (int)Sfx::COUNT;
+
+static const int HIT_PLAYER = -1;
+
+// Damage to an enemy (dense index) or to the player (HIT_PLAYER)
+struct HitEvent {
+    int target;
+    int damage;
+    float knockback;   // signed x push, enemies only
+    float hitStop;     // minimum hitstop this hit asks for
+};
+
+struct KillEvent {
+    int enemy;
+};
+
+struct CoinDropEvent {
+    Vector2 pos;
+    int count;
+};
+
+struct SfxEvent {
+    Sfx sound;
+};
+
+struct StateEvent {
+    GameState state;
+};
+
+struct CombatEvents {
+    std::vector<HitEvent> hits;
+    std::vector<KillEvent> kills;
+    std::vector<CoinDropEvent> coinDrops;
+    std::vector<SfxEvent> sounds;
+    std::vector<StateEvent> states;
+
+    void Reserve(int n) {
+        hits.reserve(n);
+        kills.reserve(n);
+        coinDrops.reserve(n);
+        sounds.reserve(n);
+        states.reserve(4);
+    }
+
+    void Clear() {
+        hits.clear();
+        kills.clear();
+        coinDrops.clear();
+        sounds.clear();
+        states.clear();
+    }
+
+    void Sound(Sfx s) { sounds.push_back({ s }); }
+};
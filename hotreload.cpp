@@ -0,0 +1,158 @@
+#include "hotreload.h"
+#include "assets.h"
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+static const int POLL_INTERVAL_MS = 500;   // GetFileModTime fallback
+static const int SETTLE_MS = 100;          // editors save in several writes
+
+static void SleepMs(int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+AssetWatcher::~AssetWatcher() {
+    Stop();
+    if (pending.packed.data) UnloadImage(pending.packed);
+}
+
+void AssetWatcher::Start(const char* spriteDirPath, const char* dataFilePath) {
+    spriteDir = spriteDirPath;
+    dataPath = dataFilePath;
+
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0) {
+        const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE;
+        size_t slash = dataPath.find_last_of('/');
+        std::string dataDir = slash == std::string::npos ? "." : dataPath.substr(0, slash);
+        spriteWatch = inotify_add_watch(inotifyFd, spriteDir.c_str(), mask);
+        dataWatch = inotify_add_watch(inotifyFd, dataDir.c_str(), mask);
+        if (spriteWatch < 0 || dataWatch < 0) {
+            TraceLog(LOG_WARNING, "RELOAD: inotify watch failed, polling instead");
+            close(inotifyFd);
+            inotifyFd = -1;
+        }
+    }
+#endif
+
+    // Baseline for the polling fallback
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) watched[t] = enemyArchetypes[t];
+    AssetFiles files;
+    ResolveAssetFiles(files, watched);
+    for (int id = 0; id < SPRITE_COUNT; ++id) {
+        modTimes[id] = files.Sprite(id) ? GetFileModTime(files.Sprite(id)) : 0;
+    }
+    modTimes[SPRITE_COUNT] = GetFileModTime(dataPath.c_str());
+
+    running.store(true);
+    thread = std::thread(&AssetWatcher::Run, this);
+    TraceLog(LOG_INFO, "RELOAD: watching %s and %s", spriteDir.c_str(), dataPath.c_str());
+}
+
+void AssetWatcher::Stop() {
+    running.store(false);
+    if (thread.joinable()) thread.join();
+#ifdef __linux__
+    if (inotifyFd >= 0) close(inotifyFd);
+    inotifyFd = -1;
+#endif
+}
+
+bool AssetWatcher::Poll(ReloadedAssets& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready) return false;
+    out = pending;
+    pending.packed = Image{};
+    ready = false;
+    return true;
+}
+
+void AssetWatcher::Run() {
+    TRACE_THREAD_NAME("hot reload");
+    while (WaitForChange()) {
+        Rebuild();
+    }
+}
+
+bool AssetWatcher::WaitForChange() {
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        const char* dataName = strrchr(dataPath.c_str(), '/');
+        dataName = dataName ? dataName + 1 : dataPath.c_str();
+
+        alignas(inotify_event) char buffer[4096];
+        bool changed = false;
+        while (running.load()) {
+            pollfd pfd = { inotifyFd, POLLIN, 0 };
+            if (poll(&pfd, 1, 200) <= 0) {
+                if (changed) return true;   // quiet for a moment: settled
+                continue;
+            }
+            ssize_t len = read(inotifyFd, buffer, sizeof(buffer));
+            for (ssize_t at = 0; at < len; ) {
+                const inotify_event* ev = (const inotify_event*)(buffer + at);
+                at += sizeof(inotify_event) + ev->len;
+                if (ev->wd == spriteWatch ||
+                    (ev->wd == dataWatch && ev->len > 0 && strcmp(ev->name, dataName) == 0)) {
+                    changed = true;
+                }
+            }
+        }
+        return false;
+    }
+#endif
+
+    while (running.load()) {
+        SleepMs(POLL_INTERVAL_MS);
+
+        AssetFiles files;
+        ResolveAssetFiles(files, watched);
+
+        bool changed = false;
+        for (int id = 0; id <= SPRITE_COUNT; ++id) {
+            const char* path = id < SPRITE_COUNT ? files.Sprite(id) : dataPath.c_str();
+            long t = path ? GetFileModTime(path) : 0;
+            if (t != modTimes[id]) {
+                modTimes[id] = t;
+                changed = true;
+            }
+        }
+        if (changed) {
+            SleepMs(SETTLE_MS);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AssetWatcher::Rebuild() {
+    TRACE_SCOPE("hot reload rebuild");
+    ReloadedAssets next;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) next.archetypes[t] = DEFAULT_ENEMY_ARCHETYPES[t];
+    LoadEnemyArchetypes(dataPath.c_str(), next.archetypes);
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) watched[t] = next.archetypes[t];
+
+    AssetFiles files;
+    ResolveAssetFiles(files, next.archetypes);
+    Image images[SPRITE_COUNT] = {};
+    for (int id = 0; id < SPRITE_COUNT; ++id) {
+        const char* path = files.Sprite(id);
+        if (path && FileExists(path)) images[id] = LoadImage(path);
+    }
+    next.packed = PackSpriteAtlas(images, next.atlas);
+    for (Image& img : images) {
+        if (img.data) UnloadImage(img);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending.packed.data) UnloadImage(pending.packed);   // superseded
+    pending = next;
+    ready = true;
+    reloads.fetch_add(1, std::memory_order_relaxed);
+}
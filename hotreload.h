@@ -0,0 +1,69 @@
+#pragma once
+
+#include "raylib.h"
+#include "atlas.h"
+#include "enemies.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// ---------------------------------------------------------
+// Hot reload
+//
+// A background thread watches the sprite directory and the enemy data
+// file (inotify on Linux, GetFileModTime polling elsewhere). When one
+// changes it re-reads the stat table, re-decodes every sheet and packs a
+// new atlas, all off the main thread. The main thread picks the result
+// up between frames with Poll and only pays for the texture upload.
+// ---------------------------------------------------------
+
+// One complete rebuild, ready to swap in
+struct ReloadedAssets {
+    EnemyArchetype archetypes[ENEMY_TYPE_COUNT]{};
+    SpriteAtlas atlas;    // rects only; no texture yet
+    Image packed{};       // caller unloads after uploading
+};
+
+struct AssetWatcher {
+    AssetWatcher() = default;
+    ~AssetWatcher();
+
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    void Start(const char* spriteDir, const char* dataPath);
+    void Stop();
+
+    // Main thread: true when a rebuild finished since the last call.
+    // Only the newest rebuild is kept.
+    bool Poll(ReloadedAssets& out);
+
+    int Reloads() const { return reloads.load(std::memory_order_relaxed); }
+
+private:
+    void Run();
+    bool WaitForChange();   // false when stopping
+    void Rebuild();
+
+    std::string spriteDir;
+    std::string dataPath;
+
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    std::atomic<int> reloads{ 0 };
+
+    std::mutex mutex;          // guards pending / ready
+    ReloadedAssets pending;
+    bool ready = false;
+
+#ifdef __linux__
+    int inotifyFd = -1;
+    int spriteWatch = -1;
+    int dataWatch = -1;
+#endif
+    // Polling fallback: sheets named by the last table read (watcher
+    // thread only), and their mod times; the last slot is the data file
+    EnemyArchetype watched[ENEMY_TYPE_COUNT]{};
+    long modTimes[SPRITE_COUNT + 1] = {};
+};
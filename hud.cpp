@@ -0,0 +1,46 @@
+#include "hud.h"
+
+bool HudSnapshot::operator==(const HudSnapshot& o) const {
+    if (classIndex != o.classIndex || hp != o.hp || maxHP != o.maxHP ||
+        coins != o.coins || comboStep != o.comboStep || bossFight != o.bossFight ||
+        shopSelection != o.shopSelection) {
+        return false;
+    }
+    for (int i = 0; i < HUD_SHOP_OPTIONS; ++i) {
+        if (shopCosts[i] != o.shopCosts[i]) return false;
+    }
+    return true;
+}
+
+void HudCache::Init(int width, int height) {
+    target = LoadRenderTexture(width, height);
+    valid = false;
+}
+
+void HudCache::Unload() {
+    if (target.id > 0) UnloadRenderTexture(target);
+    target = RenderTexture2D{};
+    valid = false;
+}
+
+bool HudCache::BeginRedraw(const HudSnapshot& now) {
+    if (valid && now == shown) return false;
+
+    shown = now;
+    valid = true;
+    redraws++;
+
+    BeginTextureMode(target);
+    ClearBackground(BLANK);
+    return true;
+}
+
+void HudCache::EndRedraw() {
+    EndTextureMode();
+}
+
+void HudCache::Draw() const {
+    // Render textures are stored upside down
+    Rectangle src = { 0, 0, (float)target.texture.width, -(float)target.texture.height };
+    DrawTextureRec(target.texture, src, { 0, 0 }, WHITE);
+}
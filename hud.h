@@ -0,0 +1,48 @@
+#pragma once
+
+#include "raylib.h"
+
+// ---------------------------------------------------------
+// Retained HUD
+//
+// HUD and shop text is drawn into a screen-sized render texture only
+// when one of the values it shows changes; every other frame just
+// blits the texture. The caller fills a HudSnapshot each frame and
+// draws the HUD contents only when BeginRedraw says so.
+// ---------------------------------------------------------
+
+static const int HUD_SHOP_OPTIONS = 3;
+
+// Everything the cached HUD depends on
+struct HudSnapshot {
+    int classIndex = -1;
+    int hp = 0;
+    int maxHP = 0;
+    int coins = 0;
+    int comboStep = 0;         // 0 = combo counter hidden
+    bool bossFight = false;
+    int shopSelection = -1;    // -1 outside the shop
+    int shopCosts[HUD_SHOP_OPTIONS] = {};
+
+    bool operator==(const HudSnapshot& o) const;
+    bool operator!=(const HudSnapshot& o) const { return !(*this == o); }
+};
+
+struct HudCache {
+    RenderTexture2D target{};
+    HudSnapshot shown;
+    bool valid = false;
+    int redraws = 0;
+
+    void Init(int width, int height);
+    void Unload();
+    void Invalidate() { valid = false; }
+
+    // When `now` differs from the cached snapshot, binds and clears the
+    // texture and returns true; draw the HUD, then call EndRedraw.
+    bool BeginRedraw(const HudSnapshot& now);
+    void EndRedraw();
+
+    // Blits the cached HUD over the screen
+    void Draw() const;
+};
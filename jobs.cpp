@@ -0,0 +1,91 @@
+#include "jobs.h"
+#include "trace.h"
+
+static const int MAX_DEFAULT_THREADS = 8;
+
+JobPool::JobPool(int threadCount) {
+    if (threadCount < 1) threadCount = 1;
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&JobPool::WorkerLoop, this);
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+int JobPool::DefaultThreadCount() {
+    int n = (int)std::thread::hardware_concurrency();
+    if (n < 1) n = 1;
+    if (n > MAX_DEFAULT_THREADS) n = MAX_DEFAULT_THREADS;
+    return n;
+}
+
+void JobPool::ParallelFor(int count, int chunkSize, const ChunkFn& fn) {
+    if (count <= 0) return;
+    int chunks = (count + chunkSize - 1) / chunkSize;
+
+    // Not worth waking anyone
+    if (workers.empty() || chunks == 1) {
+        for (int c = 0; c < chunks; ++c) {
+            int begin = c * chunkSize;
+            int end = begin + chunkSize < count ? begin + chunkSize : count;
+            fn(c, begin, end);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobChunkSize = chunkSize;
+        jobChunks = chunks;
+        nextChunk.store(0, std::memory_order_relaxed);
+        pendingWorkers = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return pendingWorkers == 0; });
+    job = nullptr;
+}
+
+void JobPool::RunChunks() {
+    for (;;) {
+        int c = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (c >= jobChunks) break;
+        int begin = c * jobChunkSize;
+        int end = begin + jobChunkSize < jobCount ? begin + jobChunkSize : jobCount;
+        TRACE_SCOPE("job chunk");
+        (*job)(c, begin, end);
+    }
+}
+
+void JobPool::WorkerLoop() {
+    TRACE_THREAD_NAME("job worker");
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+        }
+
+        RunChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pendingWorkers == 0) done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+// ---------------------------------------------------------
+// Worker pool for data-parallel loops
+//
+// ParallelFor splits [0, count) into fixed-size chunks and hands them
+// out to the workers and the calling thread. Chunk boundaries depend
+// only on count and chunkSize, never on the thread count, so work that
+// writes per-chunk output stays deterministic.
+// ---------------------------------------------------------
+
+struct JobPool {
+    using ChunkFn = std::function<void(int chunk, int begin, int end)>;
+
+    // threadCount includes the calling thread; 1 runs everything inline
+    explicit JobPool(int threadCount);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    int ThreadCount() const { return (int)workers.size() + 1; }
+
+    // Blocks until every chunk has run
+    void ParallelFor(int count, int chunkSize, const ChunkFn& fn);
+
+    // Sensible default: hardware threads, capped
+    static int DefaultThreadCount();
+
+private:
+    void WorkerLoop();
+    void RunChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // Current job (written under mutex before generation is bumped)
+    const ChunkFn* job = nullptr;
+    int jobCount = 0;
+    int jobChunkSize = 0;
+    int jobChunks = 0;
+    std::atomic<int> nextChunk{ 0 };
+
+    uint64_t generation = 0;
+    int pendingWorkers = 0;
+    bool quit = false;
+};
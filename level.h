@@ -0,0 +1,9 @@
+#pragma once
+
+// ---------------------------------------------------------
+// Level geometry (world units)
+// ---------------------------------------------------------
+
+static const float GROUND_TOP = 350.0f;
+static const float GROUND_BOTTOM = 430.0f;
+static const float LEVEL_LENGTH = 3000.0f;
@@ -1,247 +1,93 @@
+// Build (MinGW):
+//   g++ main.cpp sim.cpp enemies.cpp broadphase.cpp jobs.cpp atlas.cpp drawlist.cpp hud.cpp assets.cpp archive.cpp hotreload.cpp voices.cpp audio.cpp profiler.cpp trace.cpp -o beatemup.exe -O2 -Iraylib/include -Lraylib/lib -lraylib -lopengl32 -lgdi32 -lwinmm
+//
+// Run headless (no window / audio), e.g. for soak tests on a build box:
+//   beatemup --headless --ticks 100000 [--class knight|rogue|mage] [--seed N] [--horde N] [--threads N]
+//
+// Simulation and render rates are independent:
+//   beatemup --sim-hz 120 --fps 144
+//
+// Frame profiler: F4 shows per-phase timings; --profile records from the
+// first frame. Recorded frames are written to frame_profile.csv on exit.
+// Build with -DNO_PROFILER to compile the timers out.
+//
+// Hitch capture writes hitch_<time>_f<frame>.csv with the last few
+// seconds of frames for any frame over the given budget:
+//   beatemup --hitch-ms 50
+//
+// Trace capture for Perfetto / chrome://tracing (F5 writes a snapshot,
+// exit writes the whole session; works headless too):
+//   beatemup --trace out.json
+//
+// Bake assets/ and the audio into assets.pak (ship it next to the exe):
+//   beatemup --pack-assets [out.pak]
+
 #include "raylib.h"
+#include "sim.h"
+#include "player_classes.h"
+#include "atlas.h"
+#include "drawlist.h"
+#include "cull.h"
+#include "hud.h"
+#include "assets.h"
+#include "hotreload.h"
+#include "voices.h"
+#include "profiler.h"
+#include "trace.h"
 #include <vector>
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
 
 // ---------------------------------------------------------
-// Global textures & sprite layout
-// ---------------------------------------------------------
-
-Texture2D texKnight;
-Texture2D texRogue;
-Texture2D texMage;
-Texture2D texEnemyGrunt;
-Texture2D texEnemyFast;
-Texture2D texEnemyTank;
-Texture2D texEnemyBoss;
-Texture2D texCoin;
-Texture2D texProjectile;   // optional (not used heavily, but available)
-
-const int PLAYER_SPRITE_COLS = 4;
-const int PLAYER_SPRITE_ROWS = 3; // 0 idle, 1 run, 2 attack
-
-const int ENEMY_SPRITE_COLS = 4;
-const int ENEMY_SPRITE_ROWS = 2; // 0 walk, 1 attack
-
-// ---------------------------------------------------------
-// Enums and basic structs
-// ---------------------------------------------------------
-
-enum class GameState { MENU, PLAYING, SHOP, VICTORY, GAMEOVER };
-enum class EnemyType { GRUNT, FAST, TANK, BOSS };
-enum class PlayerClass { KNIGHT, ROGUE, MAGE };
-
-struct Coin {
-    Vector2 pos;
-    bool collected = false;
-};
-
-struct Enemy {
-    Vector2 pos;
-    Vector2 size;
-    int maxHP;
-    int hp;
-    float speed;
-    EnemyType type;
-    bool alive = true;
-
-    // Attack / telegraph
-    float attackCooldown = 0.0f;
-    bool windingUp = false;
-    float windupTimer = 0.0f;
-    bool attackingAnim = false;
-    float attackAnimTimer = 0.0f;
-
-    // Damage gating
-    int lastHitAttackId = -1;      // for melee
-    int lastProjectileHitId = -1;  // for mage projectiles
-
-    // Sprite / animation
-    Texture2D* sprite = nullptr;
-    int animFrame = 0;
-    int animRow = 0;
-    int animMaxFrames = ENEMY_SPRITE_COLS;
-    float animTimer = 0.0f;
-    float animFrameTime = 0.15f;
-};
-
-struct Projectile {
-    Vector2 pos;
-    Vector2 vel;
-    float radius;
-    float life;
-    bool active;
-    int damage;
-    int id; // unique per projectile so enemies only take one hit per projectile
-};
-
-struct Player {
-    std::string name;
-    Vector2 pos;
-    Vector2 size;
-    int maxHP;
-    int hp;
-    float speed;
-    int baseDamage;
-    bool facingRight = true;
-
-    // Attack / combo
-    bool attacking = false;
-    float attackTimer = 0.0f;
-    float attackDuration = 0.15f;
-    float comboTimer = 0.0f;
-    int comboStep = 0;
-    Rectangle attackHitbox{};
-    int coins = 0;
-
-    // Upgrades
-    int damageLevel = 0;
-    int healthLevel = 0;
-    int speedLevel = 0;
-
-    // Special abilities
-    bool blocking = false;
-    float blockTimer = 0.0f;
-    float blockCooldown = 0.0f;
-    float blockCooldownTimer = 0.0f;
-
-    bool dodging = false;
-    float dodgeTimer = 0.0f;
-    float dodgeDuration = 0.0f;
-    float dodgeCooldown = 0.0f;
-    float dodgeCooldownTimer = 0.0f;
-    float dodgeDir = 0.0f;
-
-    float blinkCooldown = 0.0f;
-    float blinkCooldownTimer = 0.0f;
-
-    bool invincible = false;
-    float invincibleTimer = 0.0f;
-
-    // Tag each melee attack instance
-    int currentAttackId = -1;
-
-    // Sprite / animation
-    Texture2D* sprite = nullptr;
-    int animFrame = 0;
-    int animRow = 0;
-    int animMaxFrames = PLAYER_SPRITE_COLS;
-    float animTimer = 0.0f;
-    float animFrameTime = 0.12f;
-};
-
-struct CharacterClass {
-    std::string name;
-    int maxHP;
-    float speed;
-    int baseDamage;
-    Color color;      // used as fallback tint / debug
-    PlayerClass type;
-};
-
-// ---------------------------------------------------------
-// Constants
+// Global textures
 // ---------------------------------------------------------
 
-static const float GROUND_TOP = 350.0f;
-static const float GROUND_BOTTOM = 430.0f;
-static const float LEVEL_LENGTH = 3000.0f;
+// Every sprite sheet lives in one atlas texture; world sprites go
+// through the batch so the whole level draws from a single texture.
+SpriteAtlas atlas;
+SpriteBatch batch;
 
-static const float ENEMY_SPAWN_INTERVAL = 3.0f;
-static const float COMBO_RESET_TIME = 1.0f;
+static const Color SHADOW_TINT = { 0, 0, 0, 120 };
 
-static float gHitStopTimer = 0.0f;
-static int gAttackCounter = 0;
-static int gProjectileCounter = 0;
+static const float PLAYER_SPRITE_SCALE = 2.5f;
+static const float ENEMY_SPRITE_SCALE = 2.3f;
+static const float COIN_SPRITE_SCALE = 1.5f;
 
-// ---------------------------------------------------------
-// Utility
-// ---------------------------------------------------------
+// Coins and bolts sit a little above the lane; keys beyond this clamp
+static const float DRAW_SORT_MARGIN = 40.0f;
 
-Rectangle MakeRect(Vector2 pos, Vector2 size) {
-    return { pos.x - size.x * 0.5f, pos.y - size.y, size.x, size.y };
+int PlayerSpriteId(PlayerClass pc) {
+    switch (pc) {
+    case PlayerClass::KNIGHT: return SPRITE_KNIGHT;
+    case PlayerClass::ROGUE:  return SPRITE_ROGUE;
+    case PlayerClass::MAGE:   return SPRITE_MAGE;
+    }
+    return SPRITE_KNIGHT;
 }
 
-bool RectOverlap(Rectangle a, Rectangle b) {
-    return CheckCollisionRecs(a, b);
-}
+// Enemy stats / sprites, overrides the built-in archetype table.
+// Relative to the executable, like the asset archive.
+static const char* ENEMY_DATA_PATH = "data/enemies.txt";
 
-// Combo damage multipliers per class
-// Tuned vs GRUNT HP (~90):
-// Knight ~3 hits, Rogue ~6, Mage ~8–9
-float GetComboMultiplier(PlayerClass pc, int step) {
-    if (step < 1) step = 1;
-    if (step > 3) step = 3;
+static const float MUSIC_VOLUME = 0.5f;
 
-    switch (pc) {
-    case PlayerClass::KNIGHT:
-        if (step == 1) return 1.0f;
-        if (step == 2) return 1.3f;
-        return 2.0f;   // big finisher
-    case PlayerClass::ROGUE:
-        if (step == 1) return 0.7f;
-        if (step == 2) return 0.9f;
-        return 1.1f;
-    case PlayerClass::MAGE:
-        if (step == 1) return 0.8f;
-        if (step == 2) return 1.0f;
-        return 1.2f;
-    }
-    return 1.0f;
-}
+static const char* PROFILE_CSV_PATH = "frame_profile.csv";
 
 // ---------------------------------------------------------
-// Enemy creation
+// Character classes
 // ---------------------------------------------------------
 
-Enemy MakeEnemy(EnemyType type, float x, float laneY) {
-    Enemy e{};
-    e.type = type;
-    e.pos = { x, laneY };
-    e.alive = true;
-    e.windingUp = false;
-    e.windupTimer = 0.0f;
-    e.attackingAnim = false;
-    e.attackAnimTimer = 0.0f;
-    e.lastHitAttackId = -1;
-    e.lastProjectileHitId = -1;
-
-    switch (type) {
-    case EnemyType::GRUNT:
-        e.size = { 40, 70 };
-        e.maxHP = e.hp = 90;
-        e.speed = 80.0f;
-        e.sprite = &texEnemyGrunt;
-        break;
-    case EnemyType::FAST:
-        e.size = { 32, 60 };
-        e.maxHP = e.hp = 80;
-        e.speed = 135.0f;
-        e.sprite = &texEnemyFast;
-        break;
-    case EnemyType::TANK:
-        e.size = { 60, 90 };
-        e.maxHP = e.hp = 150;
-        e.speed = 55.0f;
-        e.sprite = &texEnemyTank;
-        break;
-    case EnemyType::BOSS:
-        e.size = { 100, 140 };
-        e.maxHP = e.hp = 450;
-        e.speed = 70.0f;
-        e.sprite = &texEnemyBoss;
-        break;
-    }
-
-    e.animFrame = 0;
-    e.animRow = 0;
-    e.animMaxFrames = ENEMY_SPRITE_COLS;
-    e.animTimer = 0.0f;
-    e.animFrameTime = 0.15f;
-
-    return e;
-}
+static std::vector<CharacterClass> classes = {
+    { "Knight", 170, 180.0f, 20, RED,    PlayerClass::KNIGHT }, // slow, heavy
+    { "Rogue",  110, 270.0f, 14, GREEN,  PlayerClass::ROGUE },  // fast, weak
+    { "Mage",   90,  190.0f, 10, PURPLE, PlayerClass::MAGE }    // ranged
+};
 
 // ---------------------------------------------------------
 // Shop
@@ -284,643 +130,542 @@ void ApplyUpgrade(Player& p, int index) {
 }
 
 // ---------------------------------------------------------
-// Main
+// HUD (drawn into HudCache only when the snapshot changes)
 // ---------------------------------------------------------
 
-int main() {
-    const int screenWidth = 1280;
-    const int screenHeight = 720;
-
-    InitWindow(screenWidth, screenHeight, "2.5D Beat 'Em Up (raylib)");
-    InitAudioDevice();
+static HudSnapshot CaptureHud(const SimWorld& world, int classIndex, bool inShop, int shopSelection) {
+    const Player& p = world.player;
+    HudSnapshot s;
+    s.classIndex = classIndex;
+    s.hp = p.hp;
+    s.maxHP = p.maxHP;
+    s.coins = p.coins;
+    s.comboStep = (p.comboStep > 0 && p.comboTimer < COMBO_RESET_TIME) ? p.comboStep : 0;
+    s.bossFight = world.bossSpawned && !world.bossDefeated;
+    if (inShop) {
+        s.shopSelection = shopSelection;
+        for (int i = 0; i < HUD_SHOP_OPTIONS; ++i) s.shopCosts[i] = GetUpgradeCost(p, i);
+    }
+    return s;
+}
 
-    // ---- Load textures ----
-    texKnight      = LoadTexture("assets/knight.png");
-    texRogue       = LoadTexture("assets/rogue.png");
-    texMage        = LoadTexture("assets/mage.png");
-    texEnemyGrunt  = LoadTexture("assets/enemy_grunt.png");
-    texEnemyFast   = LoadTexture("assets/enemy_fast.png");
-    texEnemyTank   = LoadTexture("assets/enemy_tank.png");
-    texEnemyBoss   = LoadTexture("assets/enemy_boss.png");
-    texCoin        = LoadTexture("assets/coin.png");
-    texProjectile  = LoadTexture("assets/projectile.png"); // optional
-
-    SetTargetFPS(60);
-
-    // Character classes
-    std::vector<CharacterClass> classes = {
-        { "Knight", 170, 180.0f, 20, RED,    PlayerClass::KNIGHT }, // slow, heavy
-        { "Rogue",  110, 270.0f, 14, GREEN,  PlayerClass::ROGUE },  // fast, weak
-        { "Mage",   90,  190.0f, 10, PURPLE, PlayerClass::MAGE }    // ranged
-    };
+static void DrawHudContents(const HudSnapshot& s, const Player& player, int screenWidth, int screenHeight) {
+    DrawRectangle(20, 20, 260, 24, DARKGRAY);
+    float hpRatio = (float)s.hp / (float)s.maxHP;
+    DrawRectangle(20, 20, (int)(260 * hpRatio), 24, RED);
+    DrawRectangleLines(20, 20, 260, 24, BLACK);
+    DrawText(TextFormat("%s HP: %d/%d", player.name.c_str(), s.hp, s.maxHP),
+             26, 24, 18, RAYWHITE);
 
-    int selectedClassIndex = 0;
+    DrawText(TextFormat("Coins: %d", s.coins), 20, 60, 22, GOLD);
 
-    Player player{};
-    PlayerClass playerClass = PlayerClass::KNIGHT;
-    GameState state = GameState::MENU;
+    if (s.comboStep > 0) {
+        DrawText(TextFormat("COMBO x%d", s.comboStep), 20, 90, 24, YELLOW);
+    }
 
-    Camera2D camera{};
-    camera.offset = { (float)screenWidth / 2.0f, (float)screenHeight / 2.0f };
-    camera.zoom = 1.0f;
+    if (s.bossFight) {
+        DrawText("BOSS FIGHT!", screenWidth / 2 - 80, 20, 24, MAROON);
+    }
 
-    std::vector<Enemy> enemies;
-    std::vector<Coin> coins;
-    std::vector<Projectile> projectiles;
+    DrawText("Press TAB for Shop", screenWidth - 260, 20, 20, LIGHTGRAY);
 
-    bool bossSpawned = false;
-    bool bossDefeated = false;
-    float enemySpawnTimer = 0.0f;
-    int shopSelection = 0;
+    // Shop overlay (its translucent backdrop is drawn live, under this)
+    if (s.shopSelection >= 0) {
+        DrawRectangleLines(200, 140, screenWidth - 400, screenHeight - 280, YELLOW);
 
-    // Simple SFX hooks (files optional)
-    Sound sfxKnightSwing = LoadSound("sfx_knight_swing.wav");
-    Sound sfxRogueSwing  = LoadSound("sfx_rogue_swing.wav");
-    Sound sfxMageCast    = LoadSound("sfx_mage_cast.wav");
-    Sound sfxHit         = LoadSound("sfx_hit.wav");
-    Sound sfxEnemySwing  = LoadSound("sfx_enemy_swing.wav");
-    Sound sfxBlock       = LoadSound("sfx_block.wav");
-    Sound sfxDodge       = LoadSound("sfx_dodge.wav");
-    Sound sfxBlink       = LoadSound("sfx_blink.wav");
+        DrawText("SHOP", screenWidth / 2 - 40, 160, 28, YELLOW);
+        DrawText(TextFormat("Coins: %d", s.coins), 220, 200, 22, GOLD);
+        DrawText("UP/DOWN: select   ENTER: buy   TAB/ESC: back", 220, 230, 18, RAYWHITE);
 
-    auto ResetGame = [&]() {
-        CharacterClass cc = classes[selectedClassIndex];
-        playerClass = cc.type;
-
-        player.name = cc.name;
-        player.size = { 40, 75 };
-        player.pos = { 100.0f, (GROUND_TOP + GROUND_BOTTOM) * 0.5f };
-        player.maxHP = cc.maxHP;
-        player.hp = player.maxHP;
-        player.speed = cc.speed;
-        player.baseDamage = cc.baseDamage;
-        player.facingRight = true;
-
-        player.attacking = false;
-        player.attackTimer = 0.0f;
-        player.attackDuration = 0.15f;
-        player.comboTimer = 0.0f;
-        player.comboStep = 0;
-        player.coins = 0;
-        player.damageLevel = player.healthLevel = player.speedLevel = 0;
-        player.currentAttackId = -1;
-
-        // Abilities
-        player.blocking = false;
-        player.blockTimer = 0.0f;
-        player.blockCooldown = 0.0f;
-        player.blockCooldownTimer = 0.0f;
-
-        player.dodging = false;
-        player.dodgeTimer = 0.0f;
-        player.dodgeDuration = 0.0f;
-        player.dodgeCooldown = 0.0f;
-        player.dodgeCooldownTimer = 0.0f;
-        player.dodgeDir = 0.0f;
-
-        player.blinkCooldown = 0.0f;
-        player.blinkCooldownTimer = 0.0f;
-
-        player.invincible = false;
-        player.invincibleTimer = 0.0f;
-
-        // Per-class ability tuning
-        if (playerClass == PlayerClass::KNIGHT) {
-            player.blockCooldown = 1.0f;
-            player.sprite = &texKnight;
-        } else if (playerClass == PlayerClass::ROGUE) {
-            player.dodgeDuration = 0.25f;
-            player.dodgeCooldown = 0.9f;
-            player.sprite = &texRogue;
-        } else if (playerClass == PlayerClass::MAGE) {
-            player.blinkCooldown = 1.2f;
-            player.sprite = &texMage;
+        int listY = 270;
+        for (int i = 0; i < HUD_SHOP_OPTIONS; ++i) {
+            Color col = (s.shopSelection == i) ? SKYBLUE : RAYWHITE;
+            DrawText(TextFormat("%s (Cost: %d)", shopOptions[i].label.c_str(), s.shopCosts[i]),
+                     240, listY + i * 40, 22, col);
         }
+    }
+}
 
-        // Anim defaults
-        player.animFrame = 0;
-        player.animRow = 0;
-        player.animMaxFrames = PLAYER_SPRITE_COLS;
-        player.animTimer = 0.0f;
-        player.animFrameTime = 0.12f;
-
-        enemies.clear();
-        coins.clear();
-        projectiles.clear();
-        bossSpawned = false;
-        bossDefeated = false;
-        enemySpawnTimer = 0.0f;
+// ---------------------------------------------------------
+// Headless mode
+// ---------------------------------------------------------
 
-        camera.target = player.pos;
-        gHitStopTimer = 0.0f;
-        gAttackCounter = 0;
-        gProjectileCounter = 0;
-    };
+static bool EqualsIgnoreCase(const char* a, const char* b) {
+    while (*a && *b) {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) return false;
+        ++a; ++b;
+    }
+    return *a == *b;
+}
 
-    ResetGame();
+// Deterministic "bot" input: walk right, weave across the lane,
+// mash attack and use the special now and then.
+static InputFrame ScriptedInput(uint64_t tick) {
+    InputFrame in;
+    in.move.x = 1.0f;
+    in.move.y = ((tick / 90) % 2 == 0) ? 1.0f : -1.0f;
+    in.attackPressed = (tick % 12) == 0;
+    in.specialPressed = (tick % 150) == 75;
+    return in;
+}
 
-    // ---------------------------------------------------------
-    // Game loop
-    // ---------------------------------------------------------
-    while (!WindowShouldClose()) {
-        float realDt = GetFrameTime();
-        if (realDt > 0.05f) realDt = 0.05f;
+// Scatter extra enemies over the level for horde / stress runs
+static void SpawnHorde(SimWorld& world, int count) {
+    for (int i = 0; i < count; ++i) {
+        float x = (float)world.rng.Range(400, (int)LEVEL_LENGTH - 300);
+        float laneY = (float)world.rng.Range((int)GROUND_TOP, (int)GROUND_BOTTOM);
+        if (world.enemies.Spawn(RollEnemyType(world.rng), x, laneY) < 0) break;
+    }
+}
 
-        // Hit stop
-        gHitStopTimer -= realDt;
-        if (gHitStopTimer < 0.0f) gHitStopTimer = 0.0f;
-        float gameDt = (gHitStopTimer > 0.0f) ? 0.0f : realDt;
+static int RunHeadless(long long ticks, int classIndex, uint32_t seed, int simHz, int horde, int threads) {
+    const float dt = 1.0f / (float)simHz;
+
+    JobPool jobs(threads);
+    SimWorld world(std::max(MAX_ENEMIES, horde + 64));
+    world.jobs = &jobs;
+    world.rng.Seed(seed);
+    world.Reset(classes[classIndex]);
+    SpawnHorde(world, horde);
+
+    long long runs = 1;
+    long long victories = 0;
+    long long deaths = 0;
+    long long sfxCount = 0;
+    uint64_t checksum = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (long long i = 0; i < ticks; ++i) {
+        world.Step(ScriptedInput(world.tick), dt);
+        sfxCount += (long long)world.sfx.size();
+
+        if (world.state != GameState::PLAYING) {
+            if (world.state == GameState::VICTORY) victories++;
+            else deaths++;
+            checksum ^= world.Checksum();
+            world.Reset(classes[classIndex]);
+            SpawnHorde(world, horde);
+            runs++;
+        }
+    }
+    checksum ^= world.Checksum();
 
-        // =========================
-        // UPDATE
-        // =========================
-        if (state == GameState::MENU) {
-            if (IsKeyPressed(KEY_RIGHT)) {
-                selectedClassIndex = (selectedClassIndex + 1) % (int)classes.size();
-            }
-            if (IsKeyPressed(KEY_LEFT)) {
-                selectedClassIndex--;
-                if (selectedClassIndex < 0) selectedClassIndex = (int)classes.size() - 1;
-            }
+    auto t1 = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
 
-            if (IsKeyPressed(KEY_ENTER)) {
-                ResetGame();
-            state = GameState::PLAYING;
-            }
+    printf("headless: class=%s seed=%u ticks=%lld sim-hz=%d horde=%d threads=%d\n",
+           classes[classIndex].name.c_str(), seed, ticks, simHz, horde, jobs.ThreadCount());
+    printf("  runs=%lld victories=%lld deaths=%lld sfx=%lld\n", runs, victories, deaths, sfxCount);
+    printf("  time=%.3f s  %.0f ticks/s  %.3f us/tick\n",
+           secs, secs > 0.0 ? ticks / secs : 0.0, ticks > 0 ? secs * 1e6 / ticks : 0.0);
+    printf("  checksum=%016llx\n", (unsigned long long)checksum);
+    return 0;
+}
 
-        } else if (state == GameState::PLAYING) {
-            // -------- Input & movement ----------
-            Vector2 move = { 0, 0 };
-            if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT))  move.x -= 1.0f;
-            if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) move.x += 1.0f;
-            if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP))    move.y -= 1.0f;
-            if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN))  move.y += 1.0f;
-
-            float mag = std::sqrt(move.x * move.x + move.y * move.y);
-            if (mag > 0.0f) {
-                move.x /= mag;
-                move.y /= mag;
-            }
+// ---------------------------------------------------------
+// Player drawing (instantiated per class policy)
+// ---------------------------------------------------------
 
-            float moveSpeed = player.speed;
+template <typename Class>
+static void DrawPlayerAs(const Player& player, Vector2 playerPos, Color classColor) {
+    Color baseCol = classColor;
+    if (player.blocking)      baseCol = Fade(baseCol, 0.7f);
+    if (player.dodging)       baseCol = SKYBLUE;
+    if (player.invincible)    baseCol = Fade(baseCol, 0.6f);
+
+    Vector2 drawPos = playerPos;
+
+    // Simple per-class body motion (lean / bob)
+    if (player.attacking) {
+        float atkPhase = player.attackDuration > 0.0f
+            ? player.attackTimer / player.attackDuration
+            : 0.0f;
+        if (atkPhase < 0.0f) atkPhase = 0.0f;
+        if (atkPhase > 1.0f) atkPhase = 1.0f;
+        float swing = std::sin(atkPhase * PI);
+        float dirSign = player.facingRight ? 1.0f : -1.0f;
+
+        Vector2 lean = Class::AttackLean(swing, dirSign);
+        drawPos.x += lean.x;
+        drawPos.y += lean.y;
+    }
 
-            // Rogue dodge overrides movement
-            if (player.dodging) {
-                move = { player.dodgeDir, 0.0f };
-                moveSpeed = player.speed * 3.5f;
-            }
+    const int sprite = PlayerSpriteId(Class::TYPE);
+    if (atlas.Has(sprite)) {
+        Rectangle src = atlas.Frame(sprite, PLAYER_SPRITE_COLS, PLAYER_SPRITE_ROWS,
+                                    player.animFrame, player.animRow);
+
+        float scale = PLAYER_SPRITE_SCALE;
+        Rectangle dst = {
+            drawPos.x,
+            drawPos.y,
+            src.width * scale,
+            src.height * scale
+        };
+
+        Vector2 origin = { dst.width * 0.5f, dst.height };
+        batch.Draw(src, dst, origin, !player.facingRight, WHITE);
+    } else {
+        // Fallback: old rectangles if no sprite
+        Rectangle body = MakeRect(drawPos, player.size);
+        DrawRectangleRec(body, baseCol);
+        DrawCircle((int)drawPos.x,
+                   (int)(drawPos.y - player.size.y + 15),
+                   18,
+                   baseCol);
+    }
 
-            player.pos.x += move.x * moveSpeed * gameDt;
-            player.pos.y += move.y * player.speed * gameDt;
+    // Debug melee hitbox
+    if constexpr (Class::MELEE) {
+        if (player.attacking) {
+            DrawRectangleLinesEx(player.attackHitbox, 2.0f, Class::HitboxColor(player.comboStep));
+        }
+    }
+}
 
-            if (player.pos.x < 0) player.pos.x = 0;
-            if (player.pos.x > LEVEL_LENGTH) player.pos.x = LEVEL_LENGTH;
-            if (player.pos.y < GROUND_TOP) player.pos.y = GROUND_TOP;
-            if (player.pos.y > GROUND_BOTTOM) player.pos.y = GROUND_BOTTOM;
+using DrawPlayerFn = void (*)(const Player& player, Vector2 playerPos, Color classColor);
 
-            if (!player.dodging) {
-                if (move.x > 0) player.facingRight = true;
-                else if (move.x < 0) player.facingRight = false;
-            }
+static DrawPlayerFn PlayerDrawFn(PlayerClass pc) {
+    switch (pc) {
+    case PlayerClass::KNIGHT: return DrawPlayerAs<KnightPolicy>;
+    case PlayerClass::ROGUE:  return DrawPlayerAs<RoguePolicy>;
+    case PlayerClass::MAGE:   return DrawPlayerAs<MagePolicy>;
+    }
+    return DrawPlayerAs<KnightPolicy>;
+}
 
-            // Shop access
-            if (IsKeyPressed(KEY_TAB)) {
-                state = GameState::SHOP;
-            }
+// ---------------------------------------------------------
+// Culling extents (how far each kind of draw reaches from its feet)
+// ---------------------------------------------------------
 
-            // --- Ability timers ---
-            if (player.blockCooldownTimer > 0.0f)
-                player.blockCooldownTimer -= gameDt;
-            if (player.blockCooldownTimer < 0.0f)
-                player.blockCooldownTimer = 0.0f;
-
-            if (player.dodgeCooldownTimer > 0.0f)
-                player.dodgeCooldownTimer -= gameDt;
-            if (player.dodgeCooldownTimer < 0.0f)
-                player.dodgeCooldownTimer = 0.0f;
-
-            if (player.blinkCooldownTimer > 0.0f)
-                player.blinkCooldownTimer -= gameDt;
-            if (player.blinkCooldownTimer < 0.0f)
-                player.blinkCooldownTimer = 0.0f;
-
-            if (player.invincibleTimer > 0.0f) {
-                player.invincibleTimer -= gameDt;
-                if (player.invincibleTimer <= 0.0f) {
-                    player.invincible = false;
-                }
-            }
+static CullExtents playerCull;
+static CullExtents enemyCull[ENEMY_TYPE_COUNT];
+static CullExtents coinCull;
+static float projectileSpriteHalf = 0.0f;
+
+// Needs the atlas for sprite frame sizes
+static void ComputeCullExtents() {
+    const float shadowBelow = 3.0f + 10.0f;   // shadows sit 3px down, 10px radius
+    const float lean = 10.0f;                 // attack lean / bob, see AttackLean
+
+    // Fallback body + head, shadow radius
+    playerCull = { 30.0f + lean, 75.0f + 18.0f + lean, shadowBelow };
+    const int playerSprites[] = { SPRITE_KNIGHT, SPRITE_ROGUE, SPRITE_MAGE };
+    for (int id : playerSprites) {
+        if (!atlas.Has(id)) continue;
+        Rectangle f = atlas.Frame(id, PLAYER_SPRITE_COLS, PLAYER_SPRITE_ROWS, 0, 0);
+        playerCull.halfWidth = std::max(playerCull.halfWidth, f.width * PLAYER_SPRITE_SCALE * 0.5f + lean);
+        playerCull.above = std::max(playerCull.above, f.height * PLAYER_SPRITE_SCALE + lean);
+    }
 
-            // Knight block
-            if (playerClass == PlayerClass::KNIGHT) {
-                if (!player.blocking && player.blockCooldownTimer <= 0.0f && IsKeyPressed(KEY_K)) {
-                    player.blocking = true;
-                    player.blockTimer = 0.7f;
-                    player.blockCooldownTimer = player.blockCooldown;
-                    if (IsAudioDeviceReady()) PlaySound(sfxBlock);
-                }
-                if (player.blocking) {
-                    player.blockTimer -= gameDt;
-                    if (player.blockTimer <= 0.0f) {
-                        player.blocking = false;
-                    }
-                }
-            }
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) {
+        const EnemyArchetype& a = enemyArchetypes[t];
+        CullExtents& e = enemyCull[t];
+        e = { a.sizeX * 0.8f, a.sizeY + 8.0f, shadowBelow };   // shadow, HP bar
+        int id = EnemySpriteId((EnemyType)t);
+        if (atlas.Has(id)) {
+            Rectangle f = atlas.Frame(id, ENEMY_SPRITE_COLS, ENEMY_SPRITE_ROWS, 0, 0);
+            e.halfWidth = std::max(e.halfWidth, f.width * ENEMY_SPRITE_SCALE * 0.5f);
+            e.above = std::max(e.above, f.height * ENEMY_SPRITE_SCALE);
+        }
+    }
 
-            // Rogue dodge
-            if (playerClass == PlayerClass::ROGUE) {
-                if (!player.dodging && player.dodgeCooldownTimer <= 0.0f && IsKeyPressed(KEY_K)) {
-                    player.dodging = true;
-                    player.dodgeTimer = player.dodgeDuration;
-                    player.dodgeCooldownTimer = player.dodgeCooldown;
-                    player.dodgeDir = player.facingRight ? 1.0f : -1.0f;
-                    player.invincible = true;
-                    player.invincibleTimer = player.dodgeDuration;
-                    if (IsAudioDeviceReady()) PlaySound(sfxDodge);
-                }
-                if (player.dodging) {
-                    player.dodgeTimer -= gameDt;
-                    if (player.dodgeTimer <= 0.0f) {
-                        player.dodging = false;
-                    }
-                }
-            }
+    // Fallback coin has a dot on the ground line below it
+    float coinHalf = 6.0f;
+    if (atlas.Has(SPRITE_COIN)) coinHalf = std::max(coinHalf, atlas.rects[SPRITE_COIN].width * COIN_SPRITE_SCALE * 0.5f);
+    coinCull = { coinHalf, coinHalf, (GROUND_BOTTOM - GROUND_TOP) + 30.0f };
 
-            // Mage blink
-            if (playerClass == PlayerClass::MAGE) {
-                if (player.blinkCooldownTimer <= 0.0f && IsKeyPressed(KEY_K)) {
-                    float dir = player.facingRight ? 1.0f : -1.0f;
-                    float blinkDist = 150.0f;
-                    player.pos.x += dir * blinkDist;
-                    if (player.pos.x < 0) player.pos.x = 0;
-                    if (player.pos.x > LEVEL_LENGTH) player.pos.x = LEVEL_LENGTH;
-                    player.blinkCooldownTimer = player.blinkCooldown;
-                    player.invincible = true;
-                    player.invincibleTimer = 0.15f;
-                    if (IsAudioDeviceReady()) PlaySound(sfxBlink);
-                }
-            }
+    if (atlas.Has(SPRITE_PROJECTILE)) projectileSpriteHalf = atlas.rects[SPRITE_PROJECTILE].width * 0.5f;
+}
 
-            // -------- ATTACK / COMBO ----------
-            player.comboTimer += gameDt;
-            if (player.comboTimer > COMBO_RESET_TIME) {
-                player.comboTimer = 0.0f;
-                player.comboStep = 0;
-            }
+// New stat table and atlas from the hot-reload watcher. Enemies already
+// alive keep the size / HP / speed they spawned with.
+static void ApplyReload(ReloadedAssets& reloaded) {
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) enemyArchetypes[t] = reloaded.archetypes[t];
+
+    // Upload into a scratch atlas and only swap on success, so a failed
+    // upload keeps the current texture and the shapes texture valid
+    SpriteAtlas next = reloaded.atlas;
+    UploadSpriteAtlas(next, reloaded.packed);
+    UnloadImage(reloaded.packed);
+    if (next.texture.id > 0) {
+        Texture2D old = atlas.texture;
+        atlas = next;
+        if (old.id > 0) UnloadTexture(old);
+        TraceLog(LOG_INFO, "RELOAD: assets and enemy stats reloaded");
+    } else {
+        TraceLog(LOG_WARNING, "RELOAD: atlas upload failed, keeping the current sprites");
+    }
 
-            bool meleeClass = (playerClass == PlayerClass::KNIGHT || playerClass == PlayerClass::ROGUE);
-
-            if (!player.attacking && IsKeyPressed(KEY_J)) {
-                player.attacking = true;
-                player.attackTimer = 0.0f;
-                player.attackDuration = 0.15f; // base, will override per class/step
-                player.comboTimer = 0.0f;
-                player.comboStep++;
-                if (player.comboStep > 3) player.comboStep = 1;
-
-                float dir = player.facingRight ? 1.0f : -1.0f;
-
-                if (meleeClass) {
-                    // New melee attack ID
-                    gAttackCounter++;
-                    player.currentAttackId = gAttackCounter;
-
-                    float attackRange = 0.0f;
-                    float attackWidth = 0.0f;
-                    float attackHeight = 0.0f;
-
-                    if (playerClass == PlayerClass::KNIGHT) {
-                        if (player.comboStep == 1) {
-                            player.attackDuration = 0.28f;
-                            attackRange = 55.0f;
-                            attackWidth = 60.0f;
-                            attackHeight = 70.0f;
-                        } else if (player.comboStep == 2) {
-                            player.attackDuration = 0.32f;
-                            attackRange = 65.0f;
-                            attackWidth = 70.0f;
-                            attackHeight = 75.0f;
-                        } else {
-                            player.attackDuration = 0.40f;
-                            attackRange = 80.0f;
-                            attackWidth = 85.0f;
-                            attackHeight = 80.0f;
-                        }
-                        if (IsAudioDeviceReady()) PlaySound(sfxKnightSwing);
-                    } else { // Rogue
-                        if (player.comboStep == 1) {
-                            player.attackDuration = 0.12f;
-                            attackRange = 45.0f;
-                            attackWidth = 35.0f;
-                            attackHeight = 55.0f;
-                        } else if (player.comboStep == 2) {
-                            player.attackDuration = 0.14f;
-                            attackRange = 55.0f;
-                            attackWidth = 40.0f;
-                            attackHeight = 55.0f;
-                        } else {
-                            player.attackDuration = 0.16f;
-                            attackRange = 60.0f;
-                            attackWidth = 45.0f;
-                            attackHeight = 55.0f;
-                        }
-                        if (IsAudioDeviceReady()) PlaySound(sfxRogueSwing);
-                    }
+    ComputeCullExtents();
+}
 
-                    // Hitbox: wider and closer so it hits enemies hugging you
-                    attackWidth += 20.0f;
-                    Vector2 center = {
-                        player.pos.x + dir * (attackRange * 0.6f),
-                        player.pos.y
-                    };
-                    player.attackHitbox = MakeRect(center, { attackWidth, attackHeight });
-                } else {
-                    // Mage projectile (piercing, unique id)
-                    player.attackDuration = 0.22f;
-                    if (IsAudioDeviceReady()) PlaySound(sfxMageCast);
-
-                    float comboMul = GetComboMultiplier(playerClass, player.comboStep);
-                    int dmg = (int)std::round(player.baseDamage * comboMul);
-
-                    Projectile p{};
-                    p.active = true;
-                    p.life = 1.2f;
-                    p.radius = (player.comboStep == 1 ? 18.0f : (player.comboStep == 2 ? 22.0f : 26.0f));
-                    p.vel = { dir * (player.comboStep == 1 ? 420.0f : (player.comboStep == 2 ? 460.0f : 520.0f)), 0.0f };
-                    p.pos = { player.pos.x + dir * 30.0f, player.pos.y - 25.0f };
-                    p.damage = dmg;
-                    p.id = ++gProjectileCounter;
-
-                    projectiles.push_back(p);
-                }
-            }
+// ---------------------------------------------------------
+// Fixed timestep
+// ---------------------------------------------------------
 
-            if (player.attacking) {
-                player.attackTimer += gameDt;
-                if (player.attackTimer > player.attackDuration) {
-                    player.attacking = false;
-                }
-            }
+// Longest frame we try to catch up on; anything beyond is dropped
+// instead of spiralling into more and more ticks per frame.
+static const float MAX_FRAME_TIME = 0.25f;
 
-            // -------- PLAYER ANIMATION UPDATE --------
-            if (player.sprite && player.sprite->width > 0) {
-                bool isMoving = (std::fabs(move.x) > 0.01f || std::fabs(move.y) > 0.01f);
+// ---------------------------------------------------------
+// Main
+// ---------------------------------------------------------
 
-                if (player.attacking)      player.animRow = 2; // attack row
-                else if (isMoving)         player.animRow = 1; // run row
-                else                       player.animRow = 0; // idle row
+int main(int argc, char** argv) {
+    const auto startTime = std::chrono::steady_clock::now();
+    auto msSinceStart = [&]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    };
 
-                player.animTimer += gameDt;
-                if (player.animTimer >= player.animFrameTime) {
-                    player.animTimer = 0.0f;
-                    player.animFrame = (player.animFrame + 1) % player.animMaxFrames;
-                }
+    bool headless = false;
+    const char* packPath = nullptr;
+    long long headlessTicks = 60 * 60;
+    int headlessClass = 0;
+    uint32_t seed = 1;
+    int simHz = 120;
+    int targetFps = 60;
+    int horde = 0;
+    int threads = JobPool::DefaultThreadCount();
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "--pack-assets") == 0) {
+            packPath = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : ASSET_ARCHIVE_NAME;
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            headlessTicks = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--sim-hz") == 0 && i + 1 < argc) {
+            simHz = atoi(argv[++i]);
+            if (simHz < 10) simHz = 10;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--horde") == 0 && i + 1 < argc) {
+            horde = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracer.Start(argv[++i]);
+        } else if (strcmp(argv[i], "--hitch-ms") == 0 && i + 1 < argc) {
+            profiler.hitchBudgetMs = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profiler.enabled = true;
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            targetFps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--class") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            for (int c = 0; c < (int)classes.size(); ++c) {
+                if (EqualsIgnoreCase(name, classes[c].name.c_str())) headlessClass = c;
             }
+        }
+    }
 
-            // -------- ENEMY SPAWNING ----------
-            enemySpawnTimer += gameDt;
-            if (enemySpawnTimer > ENEMY_SPAWN_INTERVAL && !bossSpawned) {
-                enemySpawnTimer = 0.0f;
+    // Missing file just keeps the built-in table
+    const std::string enemyDataPath = AppRelativePath(ENEMY_DATA_PATH);
+    LoadEnemyArchetypes(enemyDataPath.c_str());
 
-                float laneY = GROUND_TOP + (float)GetRandomValue(0, 100);
-                if (laneY > GROUND_BOTTOM) laneY = GROUND_BOTTOM;
+    if (packPath) {
+        return PackAssetArchive(packPath) ? 0 : 1;
+    }
 
-                float spawnX = player.pos.x + (float)GetRandomValue(250, 450);
-                if (spawnX < 400.0f) spawnX = 400.0f;
-                if (spawnX > LEVEL_LENGTH - 300.0f) spawnX = LEVEL_LENGTH - 300.0f;
+    if (headless) {
+        int rc = RunHeadless(headlessTicks, headlessClass, seed, simHz, horde, threads);
+        if (tracer.Enabled()) tracer.Write();
+        return rc;
+    }
 
-                int r = GetRandomValue(0, 2);
-                EnemyType type = EnemyType::GRUNT;
-                if (r == 1) type = EnemyType::FAST;
-                else if (r == 2) type = EnemyType::TANK;
+    const int screenWidth = 1280;
+    const int screenHeight = 720;
 
-                enemies.push_back(MakeEnemy(type, spawnX, laneY));
-            }
+    InitWindow(screenWidth, screenHeight, "2.5D Beat 'Em Up (raylib)");
+    InitAudioDevice();
+    SetTargetFPS(targetFps);
+
+    // ---- Load assets ----
+    // Straight from the packed archive when there is one; otherwise the
+    // loose files are decoded on worker threads while this thread keeps a
+    // progress screen up, and GPU / audio uploads happen here afterwards.
+    double firstFrameMs = -1.0;
+    AudioMixer mixer;
+    AssetArchive archive;
+    bool fromArchive = archive.Open(AssetArchivePath().c_str()) && LoadAssetArchive(archive, atlas, mixer);
+    archive.Close();
+    if (!fromArchive) {
+        AssetLoader loader;
+        loader.Start(JobPool::DefaultThreadCount());
+
+        while (!loader.Decoded()) {
+            if (WindowShouldClose()) {
+                CloseAudioDevice();
+                CloseWindow();
+                return 0;   // loader joins its workers on the way out
+            }
+
+            float progress = (float)loader.Done() / (float)loader.Total();
+            BeginDrawing();
+            ClearBackground(BLACK);
+            DrawText("LOADING", screenWidth / 2 - 60, screenHeight / 2 - 40, 28, RAYWHITE);
+            DrawRectangle(screenWidth / 2 - 200, screenHeight / 2, 400, 16, DARKGRAY);
+            DrawRectangle(screenWidth / 2 - 200, screenHeight / 2, (int)(400 * progress), 16, GOLD);
+            EndDrawing();
+            if (firstFrameMs < 0.0) firstFrameMs = msSinceStart();
+        }
 
-            // Spawn boss near the end
-            if (!bossSpawned && player.pos.x > LEVEL_LENGTH - 600.0f) {
-                bossSpawned = true;
-                float laneY = (GROUND_TOP + GROUND_BOTTOM) * 0.5f;
-                enemies.push_back(MakeEnemy(EnemyType::BOSS, LEVEL_LENGTH - 200.0f, laneY));
-            }
+        loader.Finish(atlas, mixer);
+    }
+    ComputeCullExtents();
+    const double assetsReadyMs = msSinceStart();
 
-            // -------- PROJECTILES UPDATE (Mage) ----------
-            for (auto& p : projectiles) {
-                if (!p.active) continue;
-                p.pos.x += p.vel.x * gameDt;
-                p.pos.y += p.vel.y * gameDt;
-                p.life -= gameDt;
-                if (p.life <= 0.0f || p.pos.x < -200.0f || p.pos.x > LEVEL_LENGTH + 200.0f) {
-                    p.active = false;
-                }
-            }
+    // Audio mixes on the device thread from here on; the game only
+    // queues commands
+    mixer.Start();
+    mixer.PlayMusic(MUSIC_VOLUME);
+    VoicePool voices;
+    voices.Init(mixer);
 
-            // -------- ENEMY AI + DAMAGE ----------
-            Rectangle pr = MakeRect(player.pos, player.size);
+    // Loose files are the dev setup: pick up edits to sheets and stats
+    // while the game runs. A packed build has nothing to watch.
+    AssetWatcher watcher;
+    if (!fromArchive) watcher.Start(AppRelativePath("assets").c_str(), enemyDataPath.c_str());
 
-            for (auto& e : enemies) {
-                if (!e.alive) continue;
-                Rectangle er = MakeRect(e.pos, e.size);
+    const float simDt = 1.0f / (float)simHz;
+    float simAccumulator = 0.0f;
+    float renderAlpha = 0.0f;   // how far we are between the last two ticks
 
-                // Movement only if not in windup / attack anim
-                if (!e.windingUp && !e.attackingAnim) {
-                    Vector2 dir = { player.pos.x - e.pos.x, player.pos.y - e.pos.y };
-                    float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-                    if (dist > 5.0f) {
-                        dir.x /= dist;
-                        dir.y /= dist;
-                    } else {
-                        dir = { 0,0 };
-                    }
+    // Key presses are latched here until a tick consumes them, so a press
+    // on a frame that runs zero ticks is not lost.
+    InputFrame pendingInput;
 
-                    e.pos.x += dir.x * e.speed * gameDt;
-                    e.pos.y += dir.y * e.speed * 0.6f * gameDt;
+    int selectedClassIndex = 0;
 
-                    if (e.pos.y < GROUND_TOP) e.pos.y = GROUND_TOP;
-                    if (e.pos.y > GROUND_BOTTOM) e.pos.y = GROUND_BOTTOM;
+    JobPool jobs(threads);
+    SimWorld world;
+    world.jobs = &jobs;
+    world.rng.Seed(seed);
+    GameState state = GameState::MENU;
 
-                    er = MakeRect(e.pos, e.size);
-                }
+    // Short names for the draw code
+    Player& player = world.player;
+    EnemyPool& enemies = world.enemies;
+    FixedPool<Coin>& coins = world.coins;
+    FixedPool<Projectile>& projectiles = world.projectiles;
 
-                e.attackCooldown -= gameDt;
-                if (e.attackCooldown < 0.0f) e.attackCooldown = 0.0f;
+    // Persistent draw order buffer, sized for every pool at capacity
+    DrawList drawList;
+    ViewCuller culler;
 
-                // Enemy attack windup + telegraph
-                if (!e.windingUp && !e.attackingAnim && e.attackCooldown <= 0.0f && RectOverlap(er, pr)) {
-                    e.windingUp = true;
+    HudCache hud;
+    hud.Init(screenWidth, screenHeight);
+    bool showDrawStats = false;   // F3
+    drawList.Init(enemies.capacity + coins.Capacity() + projectiles.Capacity() + 1,
+                  GROUND_TOP - DRAW_SORT_MARGIN, GROUND_BOTTOM + DRAW_SORT_MARGIN);
 
-                    float baseWindup = 0.35f;
-                    if (e.type == EnemyType::FAST) baseWindup = 0.25f;
-                    else if (e.type == EnemyType::TANK) baseWindup = 0.45f;
-                    else if (e.type == EnemyType::BOSS) baseWindup = 0.6f;
+    Camera2D camera{};
+    camera.offset = { (float)screenWidth / 2.0f, (float)screenHeight / 2.0f };
+    camera.zoom = 1.0f;
 
-                    e.windupTimer = baseWindup;
-                }
+    int shopSelection = 0;
 
-                if (e.windingUp) {
-                    e.windupTimer -= gameDt;
-                    if (e.windupTimer <= 0.0f) {
-                        er = MakeRect(e.pos, e.size);
-                        pr = MakeRect(player.pos, player.size);
-                        if (RectOverlap(er, pr)) {
-                            int dmg = 6;
-                            if (e.type == EnemyType::FAST) dmg = 8;
-                            if (e.type == EnemyType::TANK) dmg = 13;
-                            if (e.type == EnemyType::BOSS) dmg = 20;
-
-                            int finalDmg = dmg;
-
-                            if (player.invincible) {
-                                finalDmg = 0;
-                            } else if (player.blocking && playerClass == PlayerClass::KNIGHT) {
-                                finalDmg = dmg / 3;
-                                if (IsAudioDeviceReady()) PlaySound(sfxBlock);
-                            }
-
-                            if (finalDmg > 0) {
-                                player.hp -= finalDmg;
-                                if (player.hp < 0) player.hp = 0;
-                                gHitStopTimer = std::max(gHitStopTimer, 0.05f);
-                                if (IsAudioDeviceReady()) PlaySound(sfxEnemySwing);
-                            }
-                        }
-
-                        e.windingUp = false;
-                        e.attackingAnim = true;
-                        e.attackAnimTimer = 0.22f;
-                        e.attackCooldown = 1.1f;
-                    }
-                }
+    auto ResetGame = [&]() {
+        world.Reset(classes[selectedClassIndex]);
+        camera.target = player.pos;
+        simAccumulator = 0.0f;
+        renderAlpha = 0.0f;
+        pendingInput = InputFrame{};
+    };
 
-                if (e.attackingAnim) {
-                    e.attackAnimTimer -= gameDt;
-                    if (e.attackAnimTimer <= 0.0f) {
-                        e.attackingAnim = false;
-                    }
-                }
+    ResetGame();
 
-                // Enemy animation
-                if (e.sprite && e.sprite->width > 0) {
-                    if (e.windingUp || e.attackingAnim) e.animRow = 1;
-                    else e.animRow = 0;
+    // ---------------------------------------------------------
+    // Game loop
+    // ---------------------------------------------------------
+    bool startupReported = false;
+    while (!WindowShouldClose()) {
+        profiler.BeginFrame();
+        float frameDt = GetFrameTime();
+        if (frameDt > MAX_FRAME_TIME) frameDt = MAX_FRAME_TIME;
+
+        if (IsKeyPressed(KEY_F3)) showDrawStats = !showDrawStats;
+        if (IsKeyPressed(KEY_F4)) {
+            // Recording stays on once started so the CSV covers the session
+            profiler.showOverlay = !profiler.showOverlay;
+            profiler.enabled = true;
+        }
+        if (IsKeyPressed(KEY_F5) && tracer.Enabled()) tracer.Write();
 
-                    e.animTimer += gameDt;
-                    if (e.animTimer >= e.animFrameTime) {
-                        e.animTimer = 0.0f;
-                        e.animFrame = (e.animFrame + 1) % e.animMaxFrames;
-                    }
-                }
+        // Swap in reloaded assets before anything uses this frame's tables
+        ReloadedAssets reloaded;
+        if (watcher.Poll(reloaded)) {
+            ApplyReload(reloaded);
+            hud.Invalidate();
+        }
 
-                // Player melee attack hits enemy: one hit per enemy per attackId
-                bool meleeClassLocal = (playerClass == PlayerClass::KNIGHT || playerClass == PlayerClass::ROGUE);
-                if (meleeClassLocal && player.attacking && player.currentAttackId >= 0) {
-                    er = MakeRect(e.pos, e.size);
-                    if (e.lastHitAttackId != player.currentAttackId && RectOverlap(player.attackHitbox, er)) {
-                        e.lastHitAttackId = player.currentAttackId;
-
-                        float comboMul = GetComboMultiplier(playerClass, player.comboStep);
-                        int dmg = (int)std::round(player.baseDamage * comboMul);
-                        e.hp -= dmg;
-
-                        // Hitstop mainly for melee
-                        gHitStopTimer = std::max(
-                            gHitStopTimer,
-                            (playerClass == PlayerClass::KNIGHT && player.comboStep == 3) ? 0.06f : 0.03f
-                        );
-                        if (IsAudioDeviceReady()) PlaySound(sfxHit);
-
-                        // Knockback on every melee hit (toned down)
-                        float kdDir = (e.pos.x < player.pos.x) ? -1.0f : 1.0f;
-                        float knockDist = 0.0f;
-
-                        if (playerClass == PlayerClass::KNIGHT) {
-                            if (player.comboStep == 3)      knockDist = 90.0f; // big finisher
-                            else                            knockDist = 35.0f; // modest shove
-                        } else { // Rogue
-                            knockDist = 22.0f; // lighter push
-                        }
-
-                        e.pos.x += kdDir * knockDist;
-
-                        if (e.hp <= 0) {
-                            e.alive = false;
-
-                            int coinCount = 1;
-                            if (e.type == EnemyType::TANK) coinCount = 3;
-                            if (e.type == EnemyType::BOSS) coinCount = 10;
-                            for (int i = 0; i < coinCount; ++i) {
-                                Coin c{};
-                                c.pos = { e.pos.x + (float)GetRandomValue(-10, 10),
-                                          e.pos.y - (float)GetRandomValue(0, 20) };
-                                coins.push_back(c);
-                            }
-
-                            if (e.type == EnemyType::BOSS) {
-                                bossDefeated = true;
-                                state = GameState::VICTORY;
-                            }
-                        }
-                    }
-                }
+        // =========================
+        // UPDATE
+        // =========================
+        if (state == GameState::MENU) {
+            if (IsKeyPressed(KEY_RIGHT)) {
+                selectedClassIndex = (selectedClassIndex + 1) % (int)classes.size();
+            }
+            if (IsKeyPressed(KEY_LEFT)) {
+                selectedClassIndex--;
+                if (selectedClassIndex < 0) selectedClassIndex = (int)classes.size() - 1;
             }
 
-            // Mage projectiles (piercing, 1 hit per enemy, NO hitstop)
-            if (playerClass == PlayerClass::MAGE) {
-                for (auto& p : projectiles) {
-                    if (!p.active) continue;
-                    for (auto& e : enemies) {
-                        if (!e.alive) continue;
-                        Rectangle er = MakeRect(e.pos, e.size);
-                        if (CheckCollisionCircleRec(p.pos, p.radius, er)) {
-                            if (e.lastProjectileHitId != p.id) {
-                                e.lastProjectileHitId = p.id;
-
-                                e.hp -= p.damage;
-                                if (IsAudioDeviceReady()) PlaySound(sfxHit);
-                                // No hitstop so projectile keeps flying
-
-                                if (e.hp <= 0) {
-                                    e.alive = false;
-
-                                    int coinCount = 1;
-                                    if (e.type == EnemyType::TANK) coinCount = 3;
-                                    if (e.type == EnemyType::BOSS) coinCount = 10;
-                                    for (int i = 0; i < coinCount; ++i) {
-                                        Coin c{};
-                                        c.pos = { e.pos.x + (float)GetRandomValue(-10, 10),
-                                                  e.pos.y - (float)GetRandomValue(0, 20) };
-                                        coins.push_back(c);
-                                    }
-
-                                    if (e.type == EnemyType::BOSS) {
-                                        bossDefeated = true;
-                                        state = GameState::VICTORY;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+            if (IsKeyPressed(KEY_ENTER)) {
+                ResetGame();
+            state = GameState::PLAYING;
             }
 
-            // -------- COINS ----------
-            for (auto& c : coins) {
-                if (c.collected) continue;
-                Rectangle cr = { c.pos.x - 6, c.pos.y - 6, 12, 12 };
-                pr = MakeRect(player.pos, player.size);
-                if (RectOverlap(cr, pr)) {
-                    c.collected = true;
-                    player.coins++;
+        } else if (state == GameState::PLAYING) {
+            // -------- Input ----------
+            {
+                PROFILE_SCOPE(Phase::INPUT);
+                pendingInput.move = { 0, 0 };
+                if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT))  pendingInput.move.x -= 1.0f;
+                if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) pendingInput.move.x += 1.0f;
+                if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP))    pendingInput.move.y -= 1.0f;
+                if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN))  pendingInput.move.y += 1.0f;
+                if (IsKeyPressed(KEY_J)) pendingInput.attackPressed = true;
+                if (IsKeyPressed(KEY_K)) pendingInput.specialPressed = true;
+            }
+
+            // -------- Fixed-step simulation ----------
+            {
+                PROFILE_SCOPE(Phase::SIM);
+                simAccumulator += frameDt;
+                while (simAccumulator >= simDt) {
+                    world.Step(pendingInput, simDt);
+                    simAccumulator -= simDt;
+
+                    pendingInput.attackPressed = false;
+                    pendingInput.specialPressed = false;
+
+                    for (Sfx s : world.sfx) voices.Request(s);
+                    if (world.state != GameState::PLAYING) break;
                 }
             }
+            {
+                TRACE_SCOPE("voice flush");
+                voices.Flush(GetTime());
+            }
+            renderAlpha = simAccumulator / simDt;
+            if (renderAlpha > 1.0f) renderAlpha = 1.0f;
+
+            // Shop access (time spent in the shop is not simulated)
+            if (IsKeyPressed(KEY_TAB)) {
+                state = GameState::SHOP;
+                simAccumulator = 0.0f;
+            }
 
-            // -------- HP / Game Over ----------
-            if (player.hp <= 0) {
-                state = GameState::GAMEOVER;
+            // Victory / Game Over
+            if (world.state != GameState::PLAYING) {
+                state = world.state;
             }
 
             // Update camera
-            camera.target = { player.pos.x, (GROUND_TOP + GROUND_BOTTOM) * 0.5f };
+            camera.target = { LerpPos(player.prevPos, player.pos, renderAlpha).x, (GROUND_TOP + GROUND_BOTTOM) * 0.5f };
 
         } else if (state == GameState::SHOP) {
             if (IsKeyPressed(KEY_DOWN)) {
@@ -959,6 +704,16 @@ int main() {
         // =========================
         // DRAW
         // =========================
+        PROFILE_PHASES();
+        PROFILE_PHASE(Phase::DRAW_UI);
+        if (state != GameState::MENU) {
+            HudSnapshot snap = CaptureHud(world, selectedClassIndex, state == GameState::SHOP, shopSelection);
+            if (hud.BeginRedraw(snap)) {
+                DrawHudContents(snap, player, screenWidth, screenHeight);
+                hud.EndRedraw();
+            }
+        }
+
         BeginDrawing();
         ClearBackground(BLACK);
 
@@ -999,236 +754,170 @@ int main() {
             DrawText("- GOAL: Reach the far right and defeat the boss", tutorialX, tutorialY + 160, 20, RAYWHITE);
 
         } else {
+            PROFILE_PHASE(Phase::DRAW_WORLD);
             BeginMode2D(camera);
+            batch.Begin(atlas);
+            culler.Begin(camera, screenWidth, screenHeight);
 
-            // Background (simple)
+            // Background (simple), clipped to the view
             float bgParallax = 0.4f;
             float bgX = -camera.target.x * bgParallax;
-            DrawRectangle((int)bgX - 2000, 0, 4000, screenHeight, DARKBLUE);
-            DrawRectangle((int)bgX - 2000, 200, 4000, 200, DARKPURPLE);
-
-            // Ground
-            DrawRectangle(-10000, (int)GROUND_BOTTOM, 20000, screenHeight - (int)GROUND_BOTTOM, DARKBROWN);
-            DrawRectangle(-10000, (int)GROUND_TOP, 20000, (int)(GROUND_BOTTOM - GROUND_TOP), BROWN);
-            DrawLine(-10000, (int)((GROUND_TOP + GROUND_BOTTOM) * 0.5f),
-                     10000, (int)((GROUND_TOP + GROUND_BOTTOM) * 0.5f), DARKBROWN);
-
-            // Coins
-            for (auto& c : coins) {
-                if (c.collected) continue;
-
-                if (texCoin.width > 0) {
-                    float scale = 1.5f;
-                    Rectangle src = { 0, 0, (float)texCoin.width, (float)texCoin.height };
-                    Rectangle dst = { c.pos.x, c.pos.y, texCoin.width * scale, texCoin.height * scale };
-                    Vector2 origin = { texCoin.width * scale * 0.5f, texCoin.height * scale * 0.5f };
-                    DrawTexturePro(texCoin, src, dst, origin, 0.0f, WHITE);
-                } else {
-                    DrawCircle((int)c.pos.x, (int)GROUND_BOTTOM + 3, 4, BLACK);
-                    DrawCircle((int)c.pos.x, (int)c.pos.y, 6, GOLD);
-                }
+            float bgX0 = bgX - 2000.0f;
+            float bgX1 = bgX + 2000.0f;
+            if (culler.ClipSpanX(bgX0, bgX1)) {
+                DrawRectangleRec({ bgX0, 0, bgX1 - bgX0, (float)screenHeight }, DARKBLUE);
+                DrawRectangleRec({ bgX0, 200, bgX1 - bgX0, 200 }, DARKPURPLE);
             }
 
-            // Projectiles (Mage)
-            for (auto& p : projectiles) {
-                if (!p.active) continue;
-
-                if (texProjectile.width > 0) {
-                    float scale = 1.0f;
-                    Rectangle src = { 0, 0, (float)texProjectile.width, (float)texProjectile.height };
-                    Rectangle dst = { p.pos.x, p.pos.y, texProjectile.width * scale, texProjectile.height * scale };
-                    Vector2 origin = { texProjectile.width * scale * 0.5f, texProjectile.height * scale * 0.5f };
-                    DrawTexturePro(texProjectile, src, dst, origin, 0.0f, WHITE);
-                } else {
-                    DrawCircle((int)p.pos.x, (int)p.pos.y, p.radius + 4.0f, DARKPURPLE);
-                    DrawCircle((int)p.pos.x, (int)p.pos.y, p.radius, SKYBLUE);
+            // Ground
+            float groundX0 = -10000.0f;
+            float groundX1 = 10000.0f;
+            if (culler.ClipSpanX(groundX0, groundX1)) {
+                float laneMid = (GROUND_TOP + GROUND_BOTTOM) * 0.5f;
+                DrawRectangleRec({ groundX0, GROUND_BOTTOM, groundX1 - groundX0, screenHeight - GROUND_BOTTOM }, DARKBROWN);
+                DrawRectangleRec({ groundX0, GROUND_TOP, groundX1 - groundX0, GROUND_BOTTOM - GROUND_TOP }, BROWN);
+                DrawLineV({ groundX0, laneMid }, { groundX1, laneMid }, DARKBROWN);
+            }
+
+            // Everything in the lane, back to front by ground y (fake 2.5D layering)
+            Vector2 playerPos = LerpPos(player.prevPos, player.pos, renderAlpha);
+
+            PROFILE_PHASE(Phase::DRAW_LIST);
+            drawList.Clear();
+            if (culler.Test(playerPos, playerCull)) {
+                drawList.Add(DrawKind::PLAYER, -1, playerPos.y);
+            }
+            for (int i = 0; i < enemies.count; ++i) {
+                Vector2 epos = LerpPos(enemies.PrevPos(i), enemies.Pos(i), renderAlpha);
+                if (!culler.Test(epos, enemyCull[(int)enemies.type[i]])) continue;
+                drawList.Add(DrawKind::ENEMY, i, epos.y);
+            }
+            for (int i = 0; i < coins.count; ++i) {
+                // Blink before expiring
+                const Coin& c = coins[i];
+                if (c.life < COIN_BLINK_TIME && std::fmod(c.life, 0.3f) < 0.1f) continue;
+                if (!culler.Test(c.pos, coinCull)) continue;
+                drawList.Add(DrawKind::COIN, i, c.pos.y);
+            }
+            for (int i = 0; i < projectiles.count; ++i) {
+                // Bolts fly 25px above the caster's feet; sort by the ground under them
+                const Projectile& p = projectiles[i];
+                Vector2 ppos = LerpPos(p.prevPos, p.pos, renderAlpha);
+                float r = std::max(p.radius + 4.0f, projectileSpriteHalf);
+                if (!culler.Test(ppos, { r, r, r })) continue;
+                drawList.Add(DrawKind::PROJECTILE, i, ppos.y + 25.0f);
+            }
+            drawList.Sort();
+            PROFILE_PHASE(Phase::DRAW_WORLD);
+
+            // Class-specific draw code is picked once per frame
+            DrawPlayerFn drawPlayer = PlayerDrawFn(world.playerClass);
+
+            for (const DrawItem& item : drawList) {
+                switch (item.kind) {
+                case DrawKind::PLAYER: {
+                    // Shadow under the player's feet (follows lane)
+                    batch.DrawShadow(playerPos.x, playerPos.y + 3, 30, 10, SHADOW_TINT);
+
+                    drawPlayer(player, playerPos, classes[selectedClassIndex].color);
+                    break;
                 }
-            }
 
-            // Sort entities by Y (fake 2.5D layering)
-            struct DrawEntity {
-                float y;
-                bool isPlayer;
-                Enemy* enemy;
-            };
-            std::vector<DrawEntity> entities;
-            entities.reserve(enemies.size() + 1);
-
-            for (auto& e : enemies) {
-                if (!e.alive) continue;
-                entities.push_back({ e.pos.y, false, &e });
-            }
-            entities.push_back({ player.pos.y, true, nullptr });
-
-            std::sort(entities.begin(), entities.end(),
-                      [](const DrawEntity& a, const DrawEntity& b) { return a.y < b.y; });
-
-            for (auto& ent : entities) {
-                if (ent.isPlayer) {
-// Shadow under the player's feet (follows lane)
-DrawEllipse((int)player.pos.x, (int)player.pos.y + 3, 30, 10, { 0, 0, 0, 120 });
-
-
-                    Color baseCol = classes[selectedClassIndex].color;
-                    if (player.blocking)      baseCol = Fade(baseCol, 0.7f);
-                    if (player.dodging)       baseCol = SKYBLUE;
-                    if (player.invincible)    baseCol = Fade(baseCol, 0.6f);
-
-                    Vector2 drawPos = player.pos;
-
-                    // Simple per-class body motion (lean / bob)
-                    if (player.attacking) {
-                        float atkPhase = player.attackDuration > 0.0f
-                            ? player.attackTimer / player.attackDuration
-                            : 0.0f;
-                        if (atkPhase < 0.0f) atkPhase = 0.0f;
-                        if (atkPhase > 1.0f) atkPhase = 1.0f;
-                        float swing = std::sin(atkPhase * PI);
-                        float dirSign = player.facingRight ? 1.0f : -1.0f;
-
-                        if (playerClass == PlayerClass::KNIGHT) {
-                            drawPos.x += swing * 6.0f * dirSign;
-                        } else if (playerClass == PlayerClass::ROGUE) {
-                            drawPos.x += swing * 10.0f * dirSign;
-                            drawPos.y -= swing * 4.0f;
-                        } else if (playerClass == PlayerClass::MAGE) {
-                            drawPos.y -= swing * 5.0f;
-                        }
-                    }
-
-                    if (player.sprite && player.sprite->width > 0) {
-                        int frameWidth  = player.sprite->width / PLAYER_SPRITE_COLS;
-                        int frameHeight = player.sprite->height / PLAYER_SPRITE_ROWS;
-
-                        Rectangle src = {
-                            (float)(frameWidth * player.animFrame),
-                            (float)(frameHeight * player.animRow),
-                            (float)(frameWidth * (player.facingRight ? 1 : -1)),
-                            (float)frameHeight
-                        };
-
-                        float scale = 2.5f;
-                        Rectangle dst = {
-                            drawPos.x,
-                            drawPos.y,
-                            frameWidth * scale,
-                            frameHeight * scale
-                        };
-
-                        Vector2 origin = { frameWidth * scale * 0.5f, frameHeight * scale };
-                        DrawTexturePro(*player.sprite, src, dst, origin, 0.0f, WHITE);
+                case DrawKind::COIN: {
+                    const Coin& c = coins[item.index];
+                    if (atlas.Has(SPRITE_COIN)) {
+                        batch.DrawSprite(SPRITE_COIN, c.pos, COIN_SPRITE_SCALE, { 0.5f, 0.5f }, WHITE);
                     } else {
-                        // Fallback: old rectangles if no sprite
-                        Rectangle body = MakeRect(drawPos, player.size);
-                        DrawRectangleRec(body, baseCol);
-                        DrawCircle((int)drawPos.x,
-                                   (int)(drawPos.y - player.size.y + 15),
-                                   18,
-                                   baseCol);
+                        DrawCircle((int)c.pos.x, (int)GROUND_BOTTOM + 3, 4, BLACK);
+                        DrawCircle((int)c.pos.x, (int)c.pos.y, 6, GOLD);
                     }
+                    break;
+                }
 
-                    // Debug melee hitbox
-                    if ((playerClass == PlayerClass::KNIGHT || playerClass == PlayerClass::ROGUE)
-                        && player.attacking) {
-                        DrawRectangleLinesEx(
-                            player.attackHitbox,
-                            2.0f,
-                            (playerClass == PlayerClass::KNIGHT && player.comboStep == 3) ? ORANGE : YELLOW
-                        );
+                case DrawKind::PROJECTILE: {
+                    const Projectile& p = projectiles[item.index];
+                    Vector2 ppos = LerpPos(p.prevPos, p.pos, renderAlpha);
+                    if (atlas.Has(SPRITE_PROJECTILE)) {
+                        batch.DrawSprite(SPRITE_PROJECTILE, ppos, 1.0f, { 0.5f, 0.5f }, WHITE);
+                    } else {
+                        DrawCircle((int)ppos.x, (int)ppos.y, p.radius + 4.0f, DARKPURPLE);
+                        DrawCircle((int)ppos.x, (int)ppos.y, p.radius, SKYBLUE);
                     }
+                    break;
+                }
 
-                } else {
-                    Enemy* e = ent.enemy;
-                    Rectangle er = MakeRect(e->pos, e->size);
+                case DrawKind::ENEMY: {
+                    int e = item.index;
+                    EnemyType etype = enemies.type[e];
+                    Vector2 esize = enemies.Size(e);
+                    Vector2 epos = LerpPos(enemies.PrevPos(e), enemies.Pos(e), renderAlpha);
+                    Rectangle er = MakeRect(epos, esize);
 
                     // Shadow
-DrawEllipse((int)e->pos.x, (int)e->pos.y + 3,
-            (int)(e->size.x * 0.8f), 10, { 0, 0, 0, 120 });
-
+                    batch.DrawShadow(epos.x, epos.y + 3, esize.x * 0.8f, 10, SHADOW_TINT);
 
-                    Color col = RED;
-                    if (e->type == EnemyType::FAST) col = ORANGE;
-                    else if (e->type == EnemyType::TANK) col = MAROON;
-                    else if (e->type == EnemyType::BOSS) col = DARKPURPLE;
+                    Color col = Archetype(etype).tint;
 
                     // Sprite
-                    if (e->sprite && e->sprite->width > 0) {
-                        int frameWidth  = e->sprite->width / ENEMY_SPRITE_COLS;
-                        int frameHeight = e->sprite->height / ENEMY_SPRITE_ROWS;
-
-                        bool faceRight = (player.pos.x >= e->pos.x);
-                        Rectangle src = {
-                            (float)(frameWidth * e->animFrame),
-                            (float)(frameHeight * e->animRow),
-                            (float)(frameWidth * (faceRight ? 1 : -1)),
-                            (float)frameHeight
-                        };
+                    const int sprite = EnemySpriteId(etype);
+                    if (atlas.Has(sprite)) {
+                        Rectangle src = atlas.Frame(sprite, ENEMY_SPRITE_COLS, ENEMY_SPRITE_ROWS,
+                                                    enemies.animFrame[e], enemies.animRow[e]);
 
-                        float scale = 2.3f;
+                        bool faceRight = (playerPos.x >= epos.x);
+                        float scale = ENEMY_SPRITE_SCALE;
                         Rectangle dst = {
-                            e->pos.x,
-                            e->pos.y,
-                            frameWidth * scale,
-                            frameHeight * scale
+                            epos.x,
+                            epos.y,
+                            src.width * scale,
+                            src.height * scale
                         };
-                        Vector2 origin = { frameWidth * scale * 0.5f, frameHeight * scale };
-                        DrawTexturePro(*e->sprite, src, dst, origin, 0.0f, WHITE);
+                        Vector2 origin = { dst.width * 0.5f, dst.height };
+                        batch.Draw(src, dst, origin, !faceRight, WHITE);
                     } else {
                         DrawRectangleRec(er, col);
                     }
 
-                    if (e->attackingAnim) {
+                    if (enemies.flags[e] & ENEMY_ATTACKING) {
                         DrawRectangleLinesEx(er, 3.0f, RED);
                     }
 
-                    float hpRatio = (float)e->hp / (float)e->maxHP;
+                    float hpRatio = (float)enemies.hp[e] / (float)enemies.maxHP[e];
                     DrawRectangle((int)er.x, (int)(er.y - 8), (int)er.width, 5, DARKGRAY);
                     DrawRectangle((int)er.x, (int)(er.y - 8), (int)(er.width * hpRatio), 5, RED);
+                    break;
+                }
                 }
             }
 
             // Level end gate
-            DrawRectangle((int)(LEVEL_LENGTH + 20), (int)GROUND_TOP - 40,
-                          40, (int)(GROUND_BOTTOM - GROUND_TOP + 40), GRAY);
-
-            EndMode2D();
-
-            // ----- HUD -----
-            DrawRectangle(20, 20, 260, 24, DARKGRAY);
-            float hpRatio = (float)player.hp / (float)player.maxHP;
-            DrawRectangle(20, 20, (int)(260 * hpRatio), 24, RED);
-            DrawRectangleLines(20, 20, 260, 24, BLACK);
-            DrawText(TextFormat("%s HP: %d/%d", player.name.c_str(), player.hp, player.maxHP),
-                     26, 24, 18, RAYWHITE);
-
-            DrawText(TextFormat("Coins: %d", player.coins), 20, 60, 22, GOLD);
-
-            if (player.comboStep > 0 && player.comboTimer < COMBO_RESET_TIME) {
-                DrawText(TextFormat("COMBO x%d", player.comboStep), 20, 90, 24, YELLOW);
+            if (culler.Test({ LEVEL_LENGTH + 40.0f, GROUND_BOTTOM }, { 20.0f, GROUND_BOTTOM - GROUND_TOP + 40.0f, 0.0f })) {
+                DrawRectangle((int)(LEVEL_LENGTH + 20), (int)GROUND_TOP - 40,
+                              40, (int)(GROUND_BOTTOM - GROUND_TOP + 40), GRAY);
             }
 
-            if (bossSpawned && !bossDefeated) {
-                DrawText("BOSS FIGHT!", screenWidth / 2 - 80, 20, 24, MAROON);
-            }
-
-            DrawText("Press TAB for Shop", screenWidth - 260, 20, 20, LIGHTGRAY);
+            batch.End();
+            EndMode2D();
 
-            // Shop overlay
+            // ----- HUD (cached) -----
+            PROFILE_PHASE(Phase::DRAW_UI);
             if (state == GameState::SHOP) {
                 DrawRectangle(200, 140, screenWidth - 400, screenHeight - 280, Fade(BLACK, 0.85f));
-                DrawRectangleLines(200, 140, screenWidth - 400, screenHeight - 280, YELLOW);
-
-                DrawText("SHOP", screenWidth / 2 - 40, 160, 28, YELLOW);
-                DrawText(TextFormat("Coins: %d", player.coins), 220, 200, 22, GOLD);
-                DrawText("UP/DOWN: select   ENTER: buy   TAB/ESC: back", 220, 230, 18, RAYWHITE);
-
-                int listY = 270;
-                for (int i = 0; i < 3; ++i) {
-                    Color col = (shopSelection == i) ? SKYBLUE : RAYWHITE;
-                    int cost = GetUpgradeCost(player, i);
-                    std::string label = shopOptions[i].label + " (Cost: " + std::to_string(cost) + ")";
-                    DrawText(label.c_str(), 240, listY + i * 40, 22, col);
-                }
+            }
+            hud.Draw();
+
+            if (showDrawStats) {
+                DrawText(TextFormat("drawn %d  culled %d  hud redraws %d", culler.drawn, culler.culled, hud.redraws),
+                         20, screenHeight - 30, 18, LIGHTGRAY);
+                const VoiceStats& vs = voices.stats;
+                DrawText(TextFormat("sfx req %d  played %d  deduped %d  stolen %d  dropped %d",
+                                    vs.requested, vs.played, vs.deduped, vs.stolen, vs.dropped),
+                         20, screenHeight - 52, 18, LIGHTGRAY);
+                const AudioCounters& ac = mixer.counters;
+                DrawText(TextFormat("audio queue %d (peak %d, full %d)  mix %d us (max %d)  voices %d",
+                                    ac.queueDepth.load(), ac.queueHigh.load(), ac.queueFull.load(),
+                                    ac.mixMicros.load(), ac.mixMicrosMax.load(), ac.activeVoices.load()),
+                         20, screenHeight - 74, 18, LIGHTGRAY);
             }
 
             if (state == GameState::GAMEOVER) {
@@ -1244,29 +933,32 @@ DrawEllipse((int)e->pos.x, (int)e->pos.y + 3,
             }
         }
 
+        if (profiler.showOverlay) profiler.DrawOverlay(screenWidth - 380, 16);
+
+        PROFILE_PHASE(Phase::PRESENT);
         EndDrawing();
+        PROFILE_PHASES_END();
+        profiler.SetCounts(world.enemies.count, world.projectiles.count, world.coins.count);
+        profiler.EndFrame();
+
+        if (!startupReported) {
+            startupReported = true;
+            if (firstFrameMs < 0.0) firstFrameMs = msSinceStart();
+            printf("startup: first frame %.1f ms, assets ready %.1f ms, first game frame %.1f ms\n",
+                   firstFrameMs, assetsReadyMs, msSinceStart());
+        }
     }
 
+    if (profiler.enabled && profiler.Recorded() > 0) profiler.WriteCsv(PROFILE_CSV_PATH);
+    profiler.FlushHitchReports();
+    if (tracer.Enabled()) tracer.Write();
+
     // Cleanup textures
-    UnloadTexture(texKnight);
-    UnloadTexture(texRogue);
-    UnloadTexture(texMage);
-    UnloadTexture(texEnemyGrunt);
-    UnloadTexture(texEnemyFast);
-    UnloadTexture(texEnemyTank);
-    UnloadTexture(texEnemyBoss);
-    UnloadTexture(texCoin);
-    UnloadTexture(texProjectile);
-
-    // Cleanup sounds
-    UnloadSound(sfxKnightSwing);
-    UnloadSound(sfxRogueSwing);
-    UnloadSound(sfxMageCast);
-    UnloadSound(sfxHit);
-    UnloadSound(sfxEnemySwing);
-    UnloadSound(sfxBlock);
-    UnloadSound(sfxDodge);
-    UnloadSound(sfxBlink);
+    hud.Unload();
+    UnloadSpriteAtlas(atlas);
+
+    // Stop mixing before the device goes away
+    mixer.Shutdown();
 
     CloseAudioDevice();
     CloseWindow();
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "sim.h"
+
+// ---------------------------------------------------------
+// Player class policies
+//
+// Everything that differs between Knight, Rogue and Mage. SimWorld::Step
+// and the renderer switch on PlayerClass once, then run a template
+// instantiated for the matching policy, so the per-class checks inside a
+// tick or a draw are compile-time constants and fold away.
+//
+// A policy provides:
+//   TYPE, MELEE, ATTACK_SFX
+//   COMBO / COMBO_LENGTH                          - frame data, see below
+//   InitAbilities(Player&)                        - cooldown tuning on Reset
+//   UpdateSpecial(Player&, pressed, dt, events)   - block / dodge / blink
+//   AttackLean(swing, dirSign)                    - draw offset while attacking
+// and melee classes additionally HitboxColor(step).
+// ---------------------------------------------------------
+
+// One step of a combo string. Melee classes use the hitbox fields,
+// ranged classes the projectile ones; unused fields stay 0.
+struct AttackFrame {
+    float duration;      // seconds the attack state lasts
+    float range;         // hitbox centre is pushed range * 0.6 forward
+    float width;
+    float height;
+    float damageMul;     // x baseDamage
+    float knockback;
+    float hitStop;
+    float projRadius;
+    float projSpeed;
+};
+
+// Frame data for combo step `step` (1-based). Steps cycle back to 1 after
+// COMBO_LENGTH, so a string can be any length by adding rows.
+template <typename Class>
+constexpr const AttackFrame& ComboFrame(int step) {
+    if (step < 1) step = 1;
+    if (step > Class::COMBO_LENGTH) step = Class::COMBO_LENGTH;
+    return Class::COMBO[step - 1];
+}
+
+// The dmg columns below are tuned vs GRUNT HP (~90):
+// Knight ~3 hits, Rogue ~6, Mage ~8–9
+struct KnightPolicy {
+    static constexpr PlayerClass TYPE = PlayerClass::KNIGHT;
+    static constexpr bool MELEE = true;
+    static constexpr Sfx ATTACK_SFX = Sfx::KNIGHT_SWING;
+
+    static void InitAbilities(Player& p) { p.blockCooldown = 1.0f; }
+
+    // Block: cuts incoming damage to a third while active
+    static void UpdateSpecial(Player& p, bool pressed, float gameDt, CombatEvents& events) {
+        if (!p.blocking && p.blockCooldownTimer <= 0.0f && pressed) {
+            p.blocking = true;
+            p.blockTimer = 0.7f;
+            p.blockCooldownTimer = p.blockCooldown;
+            events.Sound(Sfx::BLOCK);
+        }
+        if (p.blocking) {
+            p.blockTimer -= gameDt;
+            if (p.blockTimer <= 0.0f) {
+                p.blocking = false;
+            }
+        }
+    }
+
+    static constexpr int COMBO_LENGTH = 3;
+    static constexpr AttackFrame COMBO[COMBO_LENGTH] = {
+        //  dur    range  width  height  dmg    knock  stop
+        { 0.28f, 55.0f, 60.0f, 70.0f, 1.0f,  35.0f, 0.03f, 0.0f, 0.0f },   // modest shove
+        { 0.32f, 65.0f, 70.0f, 75.0f, 1.3f,  35.0f, 0.03f, 0.0f, 0.0f },
+        { 0.40f, 80.0f, 85.0f, 80.0f, 2.0f,  90.0f, 0.06f, 0.0f, 0.0f },   // big finisher
+    };
+
+    static Vector2 AttackLean(float swing, float dirSign) { return { swing * 6.0f * dirSign, 0.0f }; }
+    static Color HitboxColor(int step) { return step == COMBO_LENGTH ? ORANGE : YELLOW; }
+};
+
+struct RoguePolicy {
+    static constexpr PlayerClass TYPE = PlayerClass::ROGUE;
+    static constexpr bool MELEE = true;
+    static constexpr Sfx ATTACK_SFX = Sfx::ROGUE_SWING;
+
+    static void InitAbilities(Player& p) {
+        p.dodgeDuration = 0.25f;
+        p.dodgeCooldown = 0.9f;
+    }
+
+    // Dodge: fast invincible dash in the facing direction
+    static void UpdateSpecial(Player& p, bool pressed, float gameDt, CombatEvents& events) {
+        if (!p.dodging && p.dodgeCooldownTimer <= 0.0f && pressed) {
+            p.dodging = true;
+            p.dodgeTimer = p.dodgeDuration;
+            p.dodgeCooldownTimer = p.dodgeCooldown;
+            p.dodgeDir = p.facingRight ? 1.0f : -1.0f;
+            p.invincible = true;
+            p.invincibleTimer = p.dodgeDuration;
+            events.Sound(Sfx::DODGE);
+        }
+        if (p.dodging) {
+            p.dodgeTimer -= gameDt;
+            if (p.dodgeTimer <= 0.0f) {
+                p.dodging = false;
+            }
+        }
+    }
+
+    static constexpr int COMBO_LENGTH = 3;
+    static constexpr AttackFrame COMBO[COMBO_LENGTH] = {
+        //  dur    range  width  height  dmg    knock  stop
+        { 0.12f, 45.0f, 35.0f, 55.0f, 0.7f,  22.0f, 0.03f, 0.0f, 0.0f },   // lighter push
+        { 0.14f, 55.0f, 40.0f, 55.0f, 0.9f,  22.0f, 0.03f, 0.0f, 0.0f },
+        { 0.16f, 60.0f, 45.0f, 55.0f, 1.1f,  22.0f, 0.03f, 0.0f, 0.0f },
+    };
+
+    static Vector2 AttackLean(float swing, float dirSign) { return { swing * 10.0f * dirSign, -swing * 4.0f }; }
+    static Color HitboxColor(int) { return YELLOW; }
+};
+
+struct MagePolicy {
+    static constexpr PlayerClass TYPE = PlayerClass::MAGE;
+    static constexpr bool MELEE = false;
+    static constexpr Sfx ATTACK_SFX = Sfx::MAGE_CAST;
+
+    static void InitAbilities(Player& p) { p.blinkCooldown = 1.2f; }
+
+    // Blink: short teleport with a brief invincibility window
+    static void UpdateSpecial(Player& p, bool pressed, float, CombatEvents& events) {
+        if (p.blinkCooldownTimer <= 0.0f && pressed) {
+            float dir = p.facingRight ? 1.0f : -1.0f;
+            float blinkDist = 150.0f;
+            p.pos.x += dir * blinkDist;
+            if (p.pos.x < 0) p.pos.x = 0;
+            if (p.pos.x > LEVEL_LENGTH) p.pos.x = LEVEL_LENGTH;
+            p.blinkCooldownTimer = p.blinkCooldown;
+            p.invincible = true;
+            p.invincibleTimer = 0.15f;
+            events.Sound(Sfx::BLINK);
+        }
+    }
+
+    // Projectiles never cause hitstop so they keep flying
+    static constexpr int COMBO_LENGTH = 3;
+    static constexpr AttackFrame COMBO[COMBO_LENGTH] = {
+        //  dur                          dmg                radius  speed
+        { 0.22f, 0.0f, 0.0f, 0.0f, 0.8f, 0.0f, 0.0f, 18.0f, 420.0f },
+        { 0.22f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 22.0f, 460.0f },
+        { 0.22f, 0.0f, 0.0f, 0.0f, 1.2f, 0.0f, 0.0f, 26.0f, 520.0f },
+    };
+
+    static Vector2 AttackLean(float swing, float) { return { 0.0f, -swing * 5.0f }; }
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+// ---------------------------------------------------------
+// Fixed-capacity pool with swap-remove
+//
+// Live items are packed in [0, count). Storage is allocated once in
+// Init(); Add() never allocates and RemoveAt() is O(1) (the last item
+// moves into the hole, so order is not preserved).
+// ---------------------------------------------------------
+
+template <typename T>
+struct FixedPool {
+    std::vector<T> items;
+    int count = 0;
+
+    void Init(int capacity) {
+        items.assign(capacity, T{});
+        count = 0;
+    }
+
+    void Clear() { count = 0; }
+
+    int Capacity() const { return (int)items.size(); }
+    bool Full() const { return count >= (int)items.size(); }
+
+    // Returns nullptr when full
+    T* Add() {
+        if (Full()) return nullptr;
+        items[count] = T{};
+        return &items[count++];
+    }
+
+    // Like Add(), but when full the item with the least `life` left is
+    // reused instead (T must have a float `life`). Only scans when full.
+    T* AddOrRecycle() {
+        if (!Full()) return Add();
+        T* oldest = &items[0];
+        for (T& it : *this) {
+            if (it.life < oldest->life) oldest = &it;
+        }
+        *oldest = T{};
+        return oldest;
+    }
+
+    // When iterating, do not advance the index after removing
+    void RemoveAt(int i) {
+        --count;
+        if (i != count) items[i] = items[count];
+    }
+
+    T& operator[](int i) { return items[i]; }
+    const T& operator[](int i) const { return items[i]; }
+
+    T* begin() { return items.data(); }
+    T* end() { return items.data() + count; }
+    const T* begin() const { return items.data(); }
+    const T* end() const { return items.data() + count; }
+};
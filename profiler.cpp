@@ -0,0 +1,302 @@
+#include "profiler.h"
+#include "raylib.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+FrameProfiler profiler;
+
+// ---------------------------------------------------------
+// Allocation counting
+//
+// Replacing the global operator new / delete pairs is the portable way
+// to see every allocation, the standard library's included. The plain
+// and over-aligned forms are replaced; array and nothrow forms forward
+// to these. Two relaxed increments per call, so -DNO_PROFILER leaves the
+// allocator alone and the counters read zero.
+// ---------------------------------------------------------
+
+#if defined(NO_PROFILER)
+
+uint64_t AllocationCount() { return 0; }
+uint64_t AllocationBytes() { return 0; }
+
+#else
+
+static std::atomic<uint64_t> allocCount{ 0 };
+static std::atomic<uint64_t> allocBytes{ 0 };
+
+uint64_t AllocationCount() { return allocCount.load(std::memory_order_relaxed); }
+uint64_t AllocationBytes() { return allocBytes.load(std::memory_order_relaxed); }
+
+static void* CountedAlloc(std::size_t size, std::size_t align) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    for (;;) {
+        void* p;
+        if (align == 0) {
+            p = malloc(size);
+        } else {
+#ifdef _WIN32
+            p = _aligned_malloc(size, align);
+#else
+            if (posix_memalign(&p, align, size) != 0) p = nullptr;
+#endif
+        }
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void AlignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(std::size_t size) { return CountedAlloc(size, 0); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+void* operator new(std::size_t size, std::align_val_t align) { return CountedAlloc(size, (std::size_t)align); }
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { AlignedFree(p); }
+
+#endif
+
+// ---------------------------------------------------------
+// Frame profiler
+// ---------------------------------------------------------
+
+const char* PhaseName(Phase p) {
+    switch (p) {
+    case Phase::INPUT:           return "input";
+    case Phase::SIM:             return "sim";
+    case Phase::SIM_PLAYER:      return "player";
+    case Phase::SIM_SPAWN:       return "spawn";
+    case Phase::SIM_PROJECTILES: return "projectiles";
+    case Phase::SIM_ENEMY_AI:    return "enemy_ai";
+    case Phase::SIM_COLLISION:   return "collision";
+    case Phase::SIM_RESOLVE:     return "resolve";
+    case Phase::SIM_COINS:       return "coins";
+    case Phase::DRAW_LIST:       return "cull_sort";
+    case Phase::DRAW_WORLD:      return "draw_world";
+    case Phase::DRAW_UI:         return "draw_ui";
+    case Phase::PRESENT:         return "present";
+    case Phase::COUNT:           break;
+    }
+    return "frame";
+}
+
+void FrameProfiler::Record(Phase p, double startMs, double endMs) {
+    if (Recording()) Add(p, endMs - startMs);
+    if (tracer.Enabled()) tracer.Complete(PhaseName(p), tracer.FromSteadyMs(startMs), tracer.FromSteadyMs(endMs));
+}
+
+void FrameProfiler::BeginFrame() {
+    current = FrameProfile{};
+    inFrame = true;
+    frameStart = NowMs();
+    allocsAtStart = AllocationCount();
+    allocBytesAtStart = AllocationBytes();
+}
+
+void FrameProfiler::EndFrame() {
+    bool recording = Recording();
+    inFrame = false;
+    if (!recording) return;
+    current.frameMs = (float)(NowMs() - frameStart);
+    current.allocs = (uint32_t)(AllocationCount() - allocsAtStart);
+    current.allocBytes = (uint32_t)(AllocationBytes() - allocBytesAtStart);
+    ring[next] = current;
+    next = (next + 1) % PROFILE_FRAMES;
+    if (count < PROFILE_FRAMES) count++;
+    frameIndex++;
+
+    if (hitchBudgetMs > 0.0f && current.frameMs > hitchBudgetMs) CheckHitch();
+}
+
+// ---------------------------------------------------------
+// Hitch capture
+// ---------------------------------------------------------
+
+void FrameProfiler::CheckHitch() {
+    double now = NowMs();
+    if (hitchReports >= HITCH_MAX_REPORTS || now - lastHitchMs < HITCH_COOLDOWN_MS) return;
+    lastHitchMs = now;
+    hitchReports++;
+    TRACE_INSTANT("hitch");
+    QueueHitchReport();
+}
+
+// Main thread: one copy of the window and a few lines of text; the file
+// is written by HitchWriter
+void FrameProfiler::QueueHitchReport() {
+    time_t wall = time(nullptr);
+    char stamp[32];
+    char when[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&wall));
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&wall));
+
+    uint64_t hitchFrame = frameIndex - 1;
+    char path[96];
+    snprintf(path, sizeof(path), "hitch_%s_f%llu.csv", stamp, (unsigned long long)hitchFrame);
+
+    // Walk back from the hitch until the window is covered
+    int first = count - 1;
+    double covered = Frame(first).frameMs;
+    while (first > 0 && covered < HITCH_WINDOW_MS) covered += Frame(--first).frameMs;
+
+    const FrameProfile& h = Frame(count - 1);
+    int worst = 0;
+    for (int i = 1; i < PHASE_COUNT; ++i) {
+        if (h.phaseMs[i] > h.phaseMs[worst]) worst = i;
+    }
+
+    HitchReport report;
+    report.path = path;
+    report.firstFrame = frameIndex - (uint64_t)(count - first);
+    report.frames.reserve(count - first);
+    for (int age = first; age < count; ++age) report.frames.push_back(Frame(age));
+
+    // '#' lines describe the hitch; the rest is the same CSV as WriteCsv
+    char line[256];
+    std::string& text = report.summary;
+    snprintf(line, sizeof(line), "# hitch at %s\n", when);
+    text += line;
+    snprintf(line, sizeof(line), "# frame %llu: %.2f ms (budget %.2f ms)\n",
+             (unsigned long long)hitchFrame, h.frameMs, hitchBudgetMs);
+    text += line;
+    text += "# phases:";
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        snprintf(line, sizeof(line), " %s=%.2f", PhaseName((Phase)i), h.phaseMs[i]);
+        text += line;
+    }
+    text += "\n";
+    if (h.phaseMs[worst] > 0.0f) {
+        snprintf(line, sizeof(line), "# slowest phase: %s\n", PhaseName((Phase)worst));
+        text += line;
+    }
+    snprintf(line, sizeof(line), "# entities: enemies=%d projectiles=%d coins=%d\n", h.enemies, h.projectiles, h.coins);
+    text += line;
+    snprintf(line, sizeof(line), "# allocations: %u (%u bytes)\n", h.allocs, h.allocBytes);
+    text += line;
+    snprintf(line, sizeof(line), "# history: %d frames, %.0f ms\n", count - first, covered);
+    text += line;
+
+    printf("profiler: %.1f ms hitch at frame %llu, writing %s\n", h.frameMs, (unsigned long long)hitchFrame, path);
+
+    std::lock_guard<std::mutex> lock(hitchMutex);
+    hitchQueue.push_back(std::move(report));
+    if (!hitchThread.joinable()) hitchThread = std::thread(&FrameProfiler::HitchWriter, this);
+    hitchWake.notify_one();
+}
+
+void FrameProfiler::HitchWriter() {
+    TRACE_THREAD_NAME("hitch writer");
+    std::unique_lock<std::mutex> lock(hitchMutex);
+    for (;;) {
+        hitchWake.wait(lock, [this]() { return !hitchQueue.empty() || hitchStop; });
+        if (hitchQueue.empty()) return;   // stopping, everything written
+
+        HitchReport report = std::move(hitchQueue.front());
+        hitchQueue.erase(hitchQueue.begin());
+        lock.unlock();
+        WriteHitchReport(report);
+        lock.lock();
+    }
+}
+
+void FrameProfiler::WriteHitchReport(const HitchReport& report) {
+    TRACE_SCOPE("write hitch report");
+    FILE* f = fopen(report.path.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "profiler: cannot write %s\n", report.path.c_str());
+        return;
+    }
+    fputs(report.summary.c_str(), f);
+    WriteHeader(f);
+    for (size_t i = 0; i < report.frames.size(); ++i) WriteRow(f, report.firstFrame + i, report.frames[i]);
+    fclose(f);
+}
+
+void FrameProfiler::FlushHitchReports() {
+    {
+        std::lock_guard<std::mutex> lock(hitchMutex);
+        hitchStop = true;
+    }
+    hitchWake.notify_one();
+    if (hitchThread.joinable()) hitchThread.join();
+}
+
+const FrameProfile& FrameProfiler::Frame(int age) const {
+    int oldest = (next - count + PROFILE_FRAMES) % PROFILE_FRAMES;
+    return ring[(oldest + age) % PROFILE_FRAMES];
+}
+
+float FrameProfiler::Percentile(Phase p, float pct) const {
+    if (count == 0) return 0.0f;
+
+    float values[PROFILE_FRAMES];
+    for (int i = 0; i < count; ++i) {
+        const FrameProfile& f = ring[i];
+        values[i] = p == Phase::COUNT ? f.frameMs : f.phaseMs[(int)p];
+    }
+    int k = (int)(pct / 100.0f * (float)(count - 1) + 0.5f);
+    std::nth_element(values, values + k, values + count);
+    return values[k];
+}
+
+void FrameProfiler::DrawOverlay(int x, int y) const {
+    const int rowHeight = 16;
+    const int fontSize = 14;
+    DrawRectangle(x - 8, y - 6, 390, (PHASE_COUNT + 3) * rowHeight + 8, Fade(BLACK, 0.7f));
+    DrawText(TextFormat("%-12s %7s %7s %7s %7s", "ms", "last", "p50", "p95", "p99"), x, y, fontSize, GOLD);
+    if (count == 0) return;
+
+    const FrameProfile& last = Frame(count - 1);
+    for (int i = 0; i <= PHASE_COUNT; ++i) {
+        Phase p = (Phase)i;
+        bool nested = p > Phase::SIM && p <= Phase::SIM_COINS;
+        float lastMs = i == PHASE_COUNT ? last.frameMs : last.phaseMs[i];
+        DrawText(TextFormat("%s%-*s %7.2f %7.2f %7.2f %7.2f", nested ? "  " : "", nested ? 10 : 12, PhaseName(p),
+                            lastMs, Percentile(p, 50), Percentile(p, 95), Percentile(p, 99)),
+                 x, y + (i + 1) * rowHeight, fontSize, i == PHASE_COUNT ? RAYWHITE : LIGHTGRAY);
+    }
+    DrawText(TextFormat("%d frames  %u allocs  %d hitches", count, last.allocs, hitchReports),
+             x, y + (PHASE_COUNT + 2) * rowHeight, fontSize, GRAY);
+}
+
+bool FrameProfiler::WriteCsv(const char* path) const {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "profiler: cannot write %s\n", path);
+        return false;
+    }
+
+    WriteHeader(f);
+    for (int age = 0; age < count; ++age) WriteRow(f, frameIndex - (uint64_t)count + (uint64_t)age, Frame(age));
+    fclose(f);
+    printf("profiler: wrote %d frames to %s\n", count, path);
+    return true;
+}
+
+void FrameProfiler::WriteHeader(FILE* f) {
+    fprintf(f, "frame,frame_ms");
+    for (int i = 0; i < PHASE_COUNT; ++i) fprintf(f, ",%s", PhaseName((Phase)i));
+    fprintf(f, ",enemy_count,projectile_count,coin_count,allocs,alloc_bytes\n");
+}
+
+void FrameProfiler::WriteRow(FILE* f, uint64_t frame, const FrameProfile& fr) {
+    fprintf(f, "%llu,%.4f", (unsigned long long)frame, fr.frameMs);
+    for (int i = 0; i < PHASE_COUNT; ++i) fprintf(f, ",%.4f", fr.phaseMs[i]);
+    fprintf(f, ",%d,%d,%d,%u,%u\n", fr.enemies, fr.projectiles, fr.coins, fr.allocs, fr.allocBytes);
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "trace.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------
+// Frame profiler
+//
+// Per-phase wall time for the last PROFILE_FRAMES frames, kept in a
+// ring. Phases are timed with PROFILE_SCOPE (one block) or
+// PROFILE_PHASE (everything from here until the next PROFILE_PHASE,
+// PROFILE_PHASES_END or the end of the enclosing scope). Time spent in
+// a phase is summed over the frame, so a phase hit by several sim ticks
+// reports their total.
+//
+// While a trace is being captured (--trace) every phase also goes into
+// it as a scope. Building with -DNO_PROFILER compiles every timer out.
+// Otherwise a timer costs one branch until the profiler or the trace is
+// switched on (F4, --profile, --trace). Main thread only.
+//
+// Hitch capture is opt-in (--hitch-ms): it keeps the ring recording,
+// and a frame over hitchBudgetMs copies the preceding HITCH_WINDOW_MS of
+// frames into a report that a writer thread saves as a timestamped
+// hitch_*.csv in the working directory, so the report's file I/O never
+// lands on a frame. Reports are rate-limited so a slow stretch writes
+// one, not hundreds. Under -DNO_PROFILER the reports still carry frame
+// times and entity counts, but no phase breakdown and no allocation counts.
+// ---------------------------------------------------------
+
+enum class Phase {
+    INPUT,
+    SIM,            // the whole fixed-step loop; the next rows are inside it
+    SIM_PLAYER,
+    SIM_SPAWN,
+    SIM_PROJECTILES,
+    SIM_ENEMY_AI,
+    SIM_COLLISION,
+    SIM_RESOLVE,
+    SIM_COINS,
+    DRAW_LIST,      // cull + Y-sort
+    DRAW_WORLD,
+    DRAW_UI,
+    PRESENT,        // EndDrawing, including the vsync / frame-cap wait
+    COUNT
+};
+
+static const int PHASE_COUNT = (int)Phase::COUNT;
+static const int PROFILE_FRAMES = 1024;
+
+static const double HITCH_WINDOW_MS = 3000.0;      // history written per report
+static const double HITCH_COOLDOWN_MS = 5000.0;
+static const int HITCH_MAX_REPORTS = 20;           // per session
+
+const char* PhaseName(Phase p);
+
+struct FrameProfile {
+    float phaseMs[PHASE_COUNT];
+    float frameMs;
+    int enemies;
+    int projectiles;
+    int coins;
+    uint32_t allocs;        // operator new calls during the frame, all threads
+    uint32_t allocBytes;
+};
+
+// Process-wide operator new counters (profiler.cpp replaces the global
+// allocator with a counting malloc wrapper). Always 0 under -DNO_PROFILER.
+uint64_t AllocationCount();
+uint64_t AllocationBytes();
+
+struct FrameProfiler {
+    bool enabled = false;           // F4 / --profile; also writes the CSV on exit
+    bool showOverlay = false;
+    float hitchBudgetMs = 0.0f;     // --hitch-ms; 0 = hitch capture off
+
+    ~FrameProfiler() { FlushHitchReports(); }
+
+    // The ring records while the profiler or hitch capture is on, and
+    // only inside a BeginFrame / EndFrame pair: headless runs and the
+    // benchmarks never open a frame, so their timers stay one branch
+    bool Recording() const { return inFrame && (enabled || hitchBudgetMs > 0.0f); }
+
+    // Frame boundaries; BeginFrame also starts the frame clock
+    void BeginFrame();
+    void EndFrame();
+
+    void Add(Phase p, double ms) { current.phaseMs[(int)p] += (float)ms; }
+
+    // Live entity counts for the current frame
+    void SetCounts(int enemies, int projectiles, int coins) {
+        current.enemies = enemies;
+        current.projectiles = projectiles;
+        current.coins = coins;
+    }
+
+    // A timed phase, into the frame and/or the trace
+    static bool Active();
+    void Record(Phase p, double startMs, double endMs);
+
+    int Recorded() const { return count; }
+
+    // Percentile (0..100) of a phase over the recorded frames; phase
+    // COUNT means whole frames
+    float Percentile(Phase p, float pct) const;
+
+    void DrawOverlay(int x, int y) const;
+
+    // Oldest frame first. False if the file can't be written.
+    bool WriteCsv(const char* path) const;
+
+    int HitchReports() const { return hitchReports; }
+
+    // Waits for queued hitch reports to be written; call before exit
+    void FlushHitchReports();
+
+    static double NowMs() {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    const FrameProfile& Frame(int age) const;   // 0 = oldest recorded
+
+    // Everything a hitch_*.csv needs, copied out of the ring
+    struct HitchReport {
+        std::string path;
+        std::string summary;        // the '#' lines
+        uint64_t firstFrame = 0;
+        std::vector<FrameProfile> frames;
+    };
+
+    static void WriteHeader(FILE* f);
+    static void WriteRow(FILE* f, uint64_t frame, const FrameProfile& fr);
+    void CheckHitch();
+    void QueueHitchReport();
+    void HitchWriter();
+    static void WriteHitchReport(const HitchReport& report);
+
+    FrameProfile ring[PROFILE_FRAMES];
+    int next = 0;
+    int count = 0;
+    uint64_t frameIndex = 0;
+    FrameProfile current{};
+    bool inFrame = false;
+    double frameStart = 0.0;
+    uint64_t allocsAtStart = 0;
+    uint64_t allocBytesAtStart = 0;
+
+    int hitchReports = 0;
+    double lastHitchMs = -HITCH_COOLDOWN_MS;
+
+    // Writer thread, started by the first hitch
+    std::thread hitchThread;
+    std::mutex hitchMutex;          // guards hitchQueue / hitchStop
+    std::condition_variable hitchWake;
+    std::vector<HitchReport> hitchQueue;
+    bool hitchStop = false;
+};
+
+extern FrameProfiler profiler;
+
+inline bool FrameProfiler::Active() { return profiler.Recording() || tracer.Enabled(); }
+
+// Times the enclosing scope
+struct ScopedPhase {
+    explicit ScopedPhase(Phase p) : phase(p), start(FrameProfiler::Active() ? FrameProfiler::NowMs() : -1.0) {}
+    ~ScopedPhase() {
+        if (start >= 0.0) profiler.Record(phase, start, FrameProfiler::NowMs());
+    }
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    Phase phase;
+    double start;
+};
+
+// Times a run of consecutive phases; each Switch closes the previous one
+struct PhaseSequence {
+    PhaseSequence() = default;
+    ~PhaseSequence() { Close(); }
+
+    PhaseSequence(const PhaseSequence&) = delete;
+    PhaseSequence& operator=(const PhaseSequence&) = delete;
+
+    void Switch(Phase p) {
+        if (!FrameProfiler::Active()) return;
+        double now = FrameProfiler::NowMs();
+        if (open) profiler.Record(phase, start, now);
+        phase = p;
+        start = now;
+        open = true;
+    }
+
+    void Close() {
+        if (open) profiler.Record(phase, start, FrameProfiler::NowMs());
+        open = false;
+    }
+
+private:
+    Phase phase = Phase::COUNT;
+    double start = 0.0;
+    bool open = false;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if defined(NO_PROFILER)
+#define PROFILE_SCOPE(phase) ((void)0)
+#define PROFILE_PHASE(phase) ((void)0)
+#define PROFILE_PHASES() ((void)0)
+#define PROFILE_PHASES_END() ((void)0)
+#else
+#define PROFILE_SCOPE(phase) ScopedPhase PROFILE_CONCAT(profileScope_, __LINE__)(phase)
+// PROFILE_PHASES() once at the top of a scope, then PROFILE_PHASE per section
+#define PROFILE_PHASES() PhaseSequence profilePhases
+#define PROFILE_PHASE(phase) profilePhases.Switch(phase)
+#define PROFILE_PHASES_END() profilePhases.Close()
+#endif
@@ -0,0 +1,588 @@
+#include "sim.h"
+#include "player_classes.h"
+#include "profiler.h"
+#include <cmath>
+#include <algorithm>
+
+// ---------------------------------------------------------
+// Utility
+// ---------------------------------------------------------
+
+Rectangle MakeRect(Vector2 pos, Vector2 size) {
+    return { pos.x - size.x * 0.5f, pos.y - size.y, size.x, size.y };
+}
+
+Vector2 LerpPos(Vector2 from, Vector2 to, float t) {
+    return { from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t };
+}
+
+bool RectOverlap(Rectangle a, Rectangle b) {
+    return CheckCollisionRecs(a, b);
+}
+
+EnemyType RollEnemyType(SimRng& rng) {
+    int total = 0;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) total += enemyArchetypes[t].spawnWeight;
+    if (total <= 0) return EnemyType::GRUNT;
+
+    int r = rng.Range(0, total - 1);
+    for (int t = 0; t < ENEMY_TYPE_COUNT; ++t) {
+        r -= enemyArchetypes[t].spawnWeight;
+        if (r < 0) return (EnemyType)t;
+    }
+    return EnemyType::GRUNT;
+}
+
+// ---------------------------------------------------------
+// World
+// ---------------------------------------------------------
+
+SimWorld::SimWorld(int enemyCapacity) {
+    enemies.Init(enemyCapacity);
+    enemyHits.resize((enemyCapacity + ENEMY_CHUNK_SIZE - 1) / ENEMY_CHUNK_SIZE);
+    events.Reserve(256);
+    coins.Init(MAX_COINS);
+    projectiles.Init(MAX_PROJECTILES);
+    enemyGrid.Init(-400.0f, LEVEL_LENGTH + 400.0f, BROADPHASE_CELL_SIZE);
+}
+
+void SimWorld::Reset(const CharacterClass& cc) {
+    playerClass = cc.type;
+    state = GameState::PLAYING;
+
+    player.name = cc.name;
+    player.size = { 40, 75 };
+    player.pos = { 100.0f, (GROUND_TOP + GROUND_BOTTOM) * 0.5f };
+    player.prevPos = player.pos;
+    player.maxHP = cc.maxHP;
+    player.hp = player.maxHP;
+    player.speed = cc.speed;
+    player.baseDamage = cc.baseDamage;
+    player.facingRight = true;
+
+    player.attacking = false;
+    player.attackTimer = 0.0f;
+    player.attackDuration = 0.15f;
+    player.comboTimer = 0.0f;
+    player.comboStep = 0;
+    player.coins = 0;
+    player.damageLevel = player.healthLevel = player.speedLevel = 0;
+    player.currentAttackId = -1;
+
+    // Abilities
+    player.blocking = false;
+    player.blockTimer = 0.0f;
+    player.blockCooldown = 0.0f;
+    player.blockCooldownTimer = 0.0f;
+
+    player.dodging = false;
+    player.dodgeTimer = 0.0f;
+    player.dodgeDuration = 0.0f;
+    player.dodgeCooldown = 0.0f;
+    player.dodgeCooldownTimer = 0.0f;
+    player.dodgeDir = 0.0f;
+
+    player.blinkCooldown = 0.0f;
+    player.blinkCooldownTimer = 0.0f;
+
+    player.invincible = false;
+    player.invincibleTimer = 0.0f;
+
+    // Per-class ability tuning
+    switch (playerClass) {
+    case PlayerClass::KNIGHT: KnightPolicy::InitAbilities(player); break;
+    case PlayerClass::ROGUE:  RoguePolicy::InitAbilities(player); break;
+    case PlayerClass::MAGE:   MagePolicy::InitAbilities(player); break;
+    }
+
+    // Anim defaults
+    player.animFrame = 0;
+    player.animRow = 0;
+    player.animMaxFrames = PLAYER_SPRITE_COLS;
+    player.animTimer = 0.0f;
+    player.animFrameTime = 0.12f;
+
+    enemies.Clear();
+    coins.Clear();
+    projectiles.Clear();
+    bossSpawned = false;
+    bossDefeated = false;
+    enemySpawnTimer = 0.0f;
+
+    hitStopTimer = 0.0f;
+    attackCounter = 0;
+    projectileCounter = 0;
+    tick = 0;
+    events.Clear();
+    sfx.clear();
+}
+
+void SimWorld::Step(const InputFrame& input, float dt) {
+    switch (playerClass) {
+    case PlayerClass::KNIGHT: StepAs<KnightPolicy>(input, dt); break;
+    case PlayerClass::ROGUE:  StepAs<RoguePolicy>(input, dt); break;
+    case PlayerClass::MAGE:   StepAs<MagePolicy>(input, dt); break;
+    }
+}
+
+template <typename Class>
+void SimWorld::StepAs(const InputFrame& input, float dt) {
+    sfx.clear();
+    if (state != GameState::PLAYING) return;
+    tick++;
+
+    PROFILE_PHASES();
+    PROFILE_PHASE(Phase::SIM_PLAYER);
+
+    player.prevPos = player.pos;
+    for (int i = 0; i < enemies.count; ++i) {
+        enemies.prevX[i] = enemies.posX[i];
+        enemies.prevY[i] = enemies.posY[i];
+    }
+    for (auto& p : projectiles) p.prevPos = p.pos;
+
+    // Hit stop
+    hitStopTimer -= dt;
+    if (hitStopTimer < 0.0f) hitStopTimer = 0.0f;
+    float gameDt = (hitStopTimer > 0.0f) ? 0.0f : dt;
+
+    // -------- Input & movement ----------
+    Vector2 move = input.move;
+
+    float mag = std::sqrt(move.x * move.x + move.y * move.y);
+    if (mag > 0.0f) {
+        move.x /= mag;
+        move.y /= mag;
+    }
+
+    float moveSpeed = player.speed;
+
+    // Rogue dodge overrides movement
+    if (player.dodging) {
+        move = { player.dodgeDir, 0.0f };
+        moveSpeed = player.speed * 3.5f;
+    }
+
+    player.pos.x += move.x * moveSpeed * gameDt;
+    player.pos.y += move.y * player.speed * gameDt;
+
+    if (player.pos.x < 0) player.pos.x = 0;
+    if (player.pos.x > LEVEL_LENGTH) player.pos.x = LEVEL_LENGTH;
+    if (player.pos.y < GROUND_TOP) player.pos.y = GROUND_TOP;
+    if (player.pos.y > GROUND_BOTTOM) player.pos.y = GROUND_BOTTOM;
+
+    if (!player.dodging) {
+        if (move.x > 0) player.facingRight = true;
+        else if (move.x < 0) player.facingRight = false;
+    }
+
+    // --- Ability timers ---
+    if (player.blockCooldownTimer > 0.0f)
+        player.blockCooldownTimer -= gameDt;
+    if (player.blockCooldownTimer < 0.0f)
+        player.blockCooldownTimer = 0.0f;
+
+    if (player.dodgeCooldownTimer > 0.0f)
+        player.dodgeCooldownTimer -= gameDt;
+    if (player.dodgeCooldownTimer < 0.0f)
+        player.dodgeCooldownTimer = 0.0f;
+
+    if (player.blinkCooldownTimer > 0.0f)
+        player.blinkCooldownTimer -= gameDt;
+    if (player.blinkCooldownTimer < 0.0f)
+        player.blinkCooldownTimer = 0.0f;
+
+    if (player.invincibleTimer > 0.0f) {
+        player.invincibleTimer -= gameDt;
+        if (player.invincibleTimer <= 0.0f) {
+            player.invincible = false;
+        }
+    }
+
+    // Block / dodge / blink
+    Class::UpdateSpecial(player, input.specialPressed, gameDt, events);
+
+    // -------- ATTACK / COMBO ----------
+    player.comboTimer += gameDt;
+    if (player.comboTimer > COMBO_RESET_TIME) {
+        player.comboTimer = 0.0f;
+        player.comboStep = 0;
+    }
+
+    if (!player.attacking && input.attackPressed) {
+        player.attacking = true;
+        player.attackTimer = 0.0f;
+        player.attackDuration = 0.15f; // base, will override per class/step
+        player.comboTimer = 0.0f;
+        player.comboStep++;
+        if (player.comboStep > Class::COMBO_LENGTH) player.comboStep = 1;
+
+        float dir = player.facingRight ? 1.0f : -1.0f;
+        const AttackFrame& frame = ComboFrame<Class>(player.comboStep);
+
+        if constexpr (Class::MELEE) {
+            // New melee attack ID
+            attackCounter++;
+            player.currentAttackId = attackCounter;
+
+            player.attackDuration = frame.duration;
+            events.Sound(Class::ATTACK_SFX);
+
+            // Hitbox: wider and closer so it hits enemies hugging you
+            Vector2 center = {
+                player.pos.x + dir * (frame.range * 0.6f),
+                player.pos.y
+            };
+            player.attackHitbox = MakeRect(center, { frame.width + 20.0f, frame.height });
+        } else {
+            // Projectile (piercing, unique id)
+            player.attackDuration = frame.duration;
+            events.Sound(Class::ATTACK_SFX);
+
+            int dmg = (int)std::round(player.baseDamage * frame.damageMul);
+
+            // Pool full: the oldest projectile makes room
+            Projectile& p = *projectiles.AddOrRecycle();
+            p.life = 1.2f;
+            p.radius = frame.projRadius;
+            p.vel = { dir * frame.projSpeed, 0.0f };
+            p.pos = { player.pos.x + dir * 30.0f, player.pos.y - 25.0f };
+            p.prevPos = p.pos;
+            p.damage = dmg;
+            p.id = ++projectileCounter;
+        }
+    }
+
+    if (player.attacking) {
+        player.attackTimer += gameDt;
+        if (player.attackTimer > player.attackDuration) {
+            player.attacking = false;
+        }
+    }
+
+    // -------- PLAYER ANIMATION UPDATE --------
+    {
+        bool isMoving = (std::fabs(move.x) > 0.01f || std::fabs(move.y) > 0.01f);
+
+        if (player.attacking)      player.animRow = 2; // attack row
+        else if (isMoving)         player.animRow = 1; // run row
+        else                       player.animRow = 0; // idle row
+
+        player.animTimer += gameDt;
+        if (player.animTimer >= player.animFrameTime) {
+            player.animTimer = 0.0f;
+            player.animFrame = (player.animFrame + 1) % player.animMaxFrames;
+        }
+    }
+
+    // -------- ENEMY SPAWNING ----------
+    PROFILE_PHASE(Phase::SIM_SPAWN);
+    enemySpawnTimer += gameDt;
+    if (enemySpawnTimer > ENEMY_SPAWN_INTERVAL && !bossSpawned) {
+        enemySpawnTimer = 0.0f;
+
+        float laneY = GROUND_TOP + (float)rng.Range(0, 100);
+        if (laneY > GROUND_BOTTOM) laneY = GROUND_BOTTOM;
+
+        float spawnX = player.pos.x + (float)rng.Range(250, 450);
+        if (spawnX < 400.0f) spawnX = 400.0f;
+        if (spawnX > LEVEL_LENGTH - 300.0f) spawnX = LEVEL_LENGTH - 300.0f;
+
+        enemies.Spawn(RollEnemyType(rng), spawnX, laneY);
+    }
+
+    // Spawn boss near the end (retried next tick if the pool is full)
+    if (!bossSpawned && player.pos.x > LEVEL_LENGTH - 600.0f) {
+        float laneY = (GROUND_TOP + GROUND_BOTTOM) * 0.5f;
+        bossSpawned = enemies.Spawn(EnemyType::BOSS, LEVEL_LENGTH - 200.0f, laneY) >= 0;
+    }
+
+    // -------- PROJECTILES UPDATE (Mage) ----------
+    PROFILE_PHASE(Phase::SIM_PROJECTILES);
+    for (int i = 0; i < projectiles.count; ) {
+        Projectile& p = projectiles[i];
+        p.pos.x += p.vel.x * gameDt;
+        p.pos.y += p.vel.y * gameDt;
+        p.life -= gameDt;
+        if (p.life <= 0.0f || p.pos.x < -200.0f || p.pos.x > LEVEL_LENGTH + 200.0f) {
+            projectiles.RemoveAt(i);
+            continue;
+        }
+        ++i;
+    }
+
+    // -------- ENEMY AI ----------
+    PROFILE_PHASE(Phase::SIM_ENEMY_AI);
+    // Enemies only touch their own slots here; hits on the player are
+    // queued per chunk and appended below in chunk order, so the result
+    // is the same for any thread count.
+    EnemyPool& en = enemies;
+    int chunkCount = (en.count + ENEMY_CHUNK_SIZE - 1) / ENEMY_CHUNK_SIZE;
+    for (int c = 0; c < chunkCount; ++c) enemyHits[c].clear();
+
+    JobPool::ChunkFn updateChunk = [&](int chunk, int begin, int end) {
+        UpdateEnemyChunk(begin, end, gameDt, enemyHits[chunk]);
+    };
+    if (jobs) {
+        jobs->ParallelFor(en.count, ENEMY_CHUNK_SIZE, updateChunk);
+    } else {
+        for (int c = 0; c < chunkCount; ++c) {
+            updateChunk(c, c * ENEMY_CHUNK_SIZE, std::min(en.count, (c + 1) * ENEMY_CHUNK_SIZE));
+        }
+    }
+
+    for (int c = 0; c < chunkCount; ++c) {
+        events.hits.insert(events.hits.end(), enemyHits[c].begin(), enemyHits[c].end());
+    }
+
+    // -------- HIT DETECTION ----------
+    PROFILE_PHASE(Phase::SIM_COLLISION);
+    // Positions are final for this tick, so bucket enemies once and let
+    // both hit paths query only the cells they touch.
+    enemyGrid.Build(en.posX.data(), en.sizeX.data(), en.count);
+
+    // Player melee attack hits enemy: one hit per enemy per attackId
+    if constexpr (Class::MELEE) {
+        if (player.attacking && player.currentAttackId >= 0) {
+            const Rectangle hb = player.attackHitbox;
+            const AttackFrame& frame = ComboFrame<Class>(player.comboStep);
+            enemyGrid.ForEachInRange(hb.x, hb.x + hb.width, [&](int i) {
+                if (en.lastHitAttackId[i] == player.currentAttackId) return;
+                if (!RectOverlap(hb, MakeRect(en.Pos(i), en.Size(i)))) return;
+
+                en.lastHitAttackId[i] = player.currentAttackId;
+
+                int dmg = (int)std::round(player.baseDamage * frame.damageMul);
+
+                // Knockback on every melee hit (toned down)
+                float kdDir = (en.posX[i] < player.pos.x) ? -1.0f : 1.0f;
+
+                events.hits.push_back({ i, dmg, kdDir * frame.knockback, frame.hitStop });
+            });
+        }
+    }
+
+    // Projectiles (piercing, 1 hit per enemy, NO hitstop)
+    if constexpr (!Class::MELEE) {
+        CollideProjectiles();
+    }
+
+    // -------- COMBAT RESOLUTION ----------
+    PROFILE_PHASE(Phase::SIM_RESOLVE);
+    ResolveCombat();
+
+    // -------- COINS ----------
+    PROFILE_PHASE(Phase::SIM_COINS);
+    UpdateCoins(gameDt);
+
+    // -------- HP / Game Over ----------
+    if (player.hp <= 0) {
+        state = GameState::GAMEOVER;
+    }
+
+    enemies.Compact();
+}
+
+void SimWorld::UpdateEnemyChunk(int begin, int end, float gameDt, std::vector<HitEvent>& hits) {
+    EnemyPool& en = enemies;
+    const Rectangle pr = MakeRect(player.pos, player.size);
+
+    // Movement only if not in windup / attack anim (vectorized)
+    ChaseStep(en, begin, end, player.pos, gameDt);
+
+    for (int i = begin; i < end; ++i) {
+        uint32_t fl = en.flags[i];
+
+        Rectangle er = MakeRect(en.Pos(i), en.Size(i));
+
+        en.attackCooldown[i] -= gameDt;
+        if (en.attackCooldown[i] < 0.0f) en.attackCooldown[i] = 0.0f;
+
+        // Enemy attack windup + telegraph
+        if (!(fl & (ENEMY_WINDING_UP | ENEMY_ATTACKING)) && en.attackCooldown[i] <= 0.0f && RectOverlap(er, pr)) {
+            fl |= ENEMY_WINDING_UP;
+            en.windupTimer[i] = Archetype(en.type[i]).windup;
+        }
+
+        if (fl & ENEMY_WINDING_UP) {
+            en.windupTimer[i] -= gameDt;
+            if (en.windupTimer[i] <= 0.0f) {
+                if (RectOverlap(er, pr)) {
+                    hits.push_back({ HIT_PLAYER, Archetype(en.type[i]).damage, 0.0f, 0.05f });
+                }
+
+                fl &= ~ENEMY_WINDING_UP;
+                fl |= ENEMY_ATTACKING;
+                en.attackAnimTimer[i] = 0.22f;
+                en.attackCooldown[i] = 1.1f;
+            }
+        }
+
+        if (fl & ENEMY_ATTACKING) {
+            en.attackAnimTimer[i] -= gameDt;
+            if (en.attackAnimTimer[i] <= 0.0f) {
+                fl &= ~ENEMY_ATTACKING;
+            }
+        }
+        en.flags[i] = fl;
+
+        // Enemy animation
+        en.animRow[i] = (fl & (ENEMY_WINDING_UP | ENEMY_ATTACKING)) ? 1 : 0;
+
+        en.animTimer[i] += gameDt;
+        if (en.animTimer[i] >= ENEMY_ANIM_FRAME_TIME) {
+            en.animTimer[i] = 0.0f;
+            en.animFrame[i] = (en.animFrame[i] + 1) % ENEMY_SPRITE_COLS;
+        }
+    }
+}
+
+void SimWorld::ResolveCombat() {
+    EnemyPool& en = enemies;
+
+    // Hits, in the order they were detected
+    for (const HitEvent& hit : events.hits) {
+        if (hit.target == HIT_PLAYER) {
+            int finalDmg = hit.damage;
+
+            if (player.invincible) {
+                finalDmg = 0;
+            } else if (player.blocking) {   // only the Knight can block
+                finalDmg = hit.damage / 3;
+                events.Sound(Sfx::BLOCK);
+            }
+
+            if (finalDmg > 0) {
+                player.hp -= finalDmg;
+                if (player.hp < 0) player.hp = 0;
+                hitStopTimer = std::max(hitStopTimer, hit.hitStop);
+                events.Sound(Sfx::ENEMY_SWING);
+            }
+            continue;
+        }
+
+        int i = hit.target;
+        if (en.IsDead(i)) continue;   // killed by an earlier hit this tick
+
+        en.hp[i] -= hit.damage;
+        en.posX[i] += hit.knockback;
+        hitStopTimer = std::max(hitStopTimer, hit.hitStop);
+        events.Sound(Sfx::HIT);
+
+        if (en.hp[i] <= 0) {
+            en.Kill(i);
+            events.kills.push_back({ i });
+        }
+    }
+
+    // Kills -> loot and state changes
+    for (const KillEvent& kill : events.kills) {
+        EnemyType type = en.type[kill.enemy];
+        events.coinDrops.push_back({ en.Pos(kill.enemy), Archetype(type).coins });
+
+        if (type == EnemyType::BOSS) {
+            events.states.push_back({ GameState::VICTORY });
+        }
+    }
+
+    for (const CoinDropEvent& drop : events.coinDrops) {
+        for (int c = 0; c < drop.count; ++c) {
+            DropCoin({ drop.pos.x + (float)rng.Range(-10, 10),
+                       drop.pos.y - (float)rng.Range(0, 20) });
+        }
+    }
+
+    for (const StateEvent& change : events.states) {
+        if (change.state == GameState::VICTORY) bossDefeated = true;
+        state = change.state;
+    }
+
+    for (const SfxEvent& s : events.sounds) {
+        sfx.push_back(s.sound);
+    }
+
+    events.Clear();
+}
+
+void SimWorld::CollideProjectiles() {
+    EnemyPool& en = enemies;
+    for (auto& p : projectiles) {
+        enemyGrid.ForEachInRange(p.pos.x - p.radius, p.pos.x + p.radius, [&](int i) {
+            if (en.lastProjectileHitId[i] == p.id) return;
+            if (!CheckCollisionCircleRec(p.pos, p.radius, MakeRect(en.Pos(i), en.Size(i)))) return;
+
+            en.lastProjectileHitId[i] = p.id;
+
+            // No hitstop so projectile keeps flying
+            events.hits.push_back({ i, p.damage, 0.0f, 0.0f });
+        });
+    }
+}
+
+void SimWorld::UpdateCoins(float gameDt) {
+    Rectangle pr = MakeRect(player.pos, player.size);
+    for (int i = 0; i < coins.count; ) {
+        Coin& c = coins[i];
+        c.life -= gameDt;
+        if (c.life <= 0.0f) {
+            coins.RemoveAt(i);
+            continue;
+        }
+
+        Rectangle cr = { c.pos.x - 6, c.pos.y - 6, 12, 12 };
+        if (RectOverlap(cr, pr)) {
+            player.coins++;
+            coins.RemoveAt(i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+void SimWorld::DropCoin(Vector2 pos) {
+    Coin* c = coins.AddOrRecycle();
+    c->pos = pos;
+    c->life = COIN_LIFETIME;
+}
+
+// ---------------------------------------------------------
+// Checksum (FNV-1a over the fields that drive gameplay)
+// ---------------------------------------------------------
+
+static void HashBytes(uint64_t& h, const void* data, size_t size) {
+    const unsigned char* b = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= b[i];
+        h *= 1099511628211ull;
+    }
+}
+
+template <typename T>
+static void HashValue(uint64_t& h, const T& v) {
+    HashBytes(h, &v, sizeof(T));
+}
+
+uint64_t SimWorld::Checksum() const {
+    uint64_t h = 14695981039346656037ull;
+    HashValue(h, tick);
+    HashValue(h, (int)state);
+    HashValue(h, player.pos);
+    HashValue(h, player.hp);
+    HashValue(h, player.coins);
+    HashValue(h, player.comboStep);
+
+    for (int i = 0; i < enemies.count; ++i) {
+        HashValue(h, enemies.posX[i]);
+        HashValue(h, enemies.posY[i]);
+        HashValue(h, enemies.hp[i]);
+        HashValue(h, (int)enemies.type[i]);
+    }
+    for (const auto& c : coins) {
+        HashValue(h, c.pos);
+    }
+    for (const auto& p : projectiles) {
+        HashValue(h, p.pos);
+        HashValue(h, p.id);
+    }
+    return h;
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "raylib.h"
+#include "level.h"
+#include "enemies.h"
+#include "pool.h"
+#include "broadphase.h"
+#include "jobs.h"
+#include "events.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ---------------------------------------------------------
+// Simulation core
+//
+// Everything that happens while GameState::PLAYING lives here.
+// Nothing in this module may call raylib draw / input / audio
+// functions, so it can run without a window (see --headless).
+// ---------------------------------------------------------
+
+const int PLAYER_SPRITE_COLS = 4;
+const int PLAYER_SPRITE_ROWS = 3; // 0 idle, 1 run, 2 attack
+
+// ---------------------------------------------------------
+// Enums and basic structs
+// ---------------------------------------------------------
+
+enum class PlayerClass { KNIGHT, ROGUE, MAGE };
+
+struct Coin {
+    Vector2 pos;
+    float life;   // seconds until it disappears
+};
+
+struct Projectile {
+    Vector2 pos;
+    Vector2 prevPos;
+    Vector2 vel;
+    float radius;
+    float life;
+    int damage;
+    int id; // unique per projectile so enemies only take one hit per projectile
+};
+
+struct Player {
+    std::string name;
+    Vector2 pos;
+    Vector2 prevPos;
+    Vector2 size;
+    int maxHP;
+    int hp;
+    float speed;
+    int baseDamage;
+    bool facingRight = true;
+
+    // Attack / combo
+    bool attacking = false;
+    float attackTimer = 0.0f;
+    float attackDuration = 0.15f;
+    float comboTimer = 0.0f;
+    int comboStep = 0;
+    Rectangle attackHitbox{};
+    int coins = 0;
+
+    // Upgrades
+    int damageLevel = 0;
+    int healthLevel = 0;
+    int speedLevel = 0;
+
+    // Special abilities
+    bool blocking = false;
+    float blockTimer = 0.0f;
+    float blockCooldown = 0.0f;
+    float blockCooldownTimer = 0.0f;
+
+    bool dodging = false;
+    float dodgeTimer = 0.0f;
+    float dodgeDuration = 0.0f;
+    float dodgeCooldown = 0.0f;
+    float dodgeCooldownTimer = 0.0f;
+    float dodgeDir = 0.0f;
+
+    float blinkCooldown = 0.0f;
+    float blinkCooldownTimer = 0.0f;
+
+    bool invincible = false;
+    float invincibleTimer = 0.0f;
+
+    // Tag each melee attack instance
+    int currentAttackId = -1;
+
+    // Animation
+    int animFrame = 0;
+    int animRow = 0;
+    int animMaxFrames = PLAYER_SPRITE_COLS;
+    float animTimer = 0.0f;
+    float animFrameTime = 0.12f;
+};
+
+struct CharacterClass {
+    std::string name;
+    int maxHP;
+    float speed;
+    int baseDamage;
+    Color color;      // used as fallback tint / debug
+    PlayerClass type;
+};
+
+// ---------------------------------------------------------
+// Constants
+// ---------------------------------------------------------
+
+static const float ENEMY_SPAWN_INTERVAL = 3.0f;
+static const float COMBO_RESET_TIME = 1.0f;
+
+static const int MAX_PROJECTILES = 1024;
+static const float BROADPHASE_CELL_SIZE = 64.0f;
+static const int ENEMY_CHUNK_SIZE = 512;      // enemies per parallel work item
+
+static const int MAX_COINS = 256;
+static const float COIN_LIFETIME = 15.0f;
+static const float COIN_BLINK_TIME = 3.0f;   // coins blink this long before expiring
+
+// ---------------------------------------------------------
+// Utility
+// ---------------------------------------------------------
+
+Rectangle MakeRect(Vector2 pos, Vector2 size);
+Vector2 LerpPos(Vector2 from, Vector2 to, float t);
+bool RectOverlap(Rectangle a, Rectangle b);
+
+// Small deterministic RNG so a seed + input stream always replays the same
+// (raylib's GetRandomValue is global state shared with the rest of the app)
+struct SimRng {
+    uint32_t state = 0x9E3779B9u;
+
+    void Seed(uint32_t seed) { state = seed ? seed : 0x9E3779B9u; }
+
+    uint32_t Next() {
+        // xorshift32
+        uint32_t x = state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state = x;
+        return x;
+    }
+
+    // Inclusive range, same contract as GetRandomValue
+    int Range(int min, int max) {
+        if (min > max) { int t = min; min = max; max = t; }
+        return min + (int)(Next() % (uint32_t)(max - min + 1));
+    }
+};
+
+// Weighted pick over the archetype spawn weights (GRUNT if all are 0)
+EnemyType RollEnemyType(SimRng& rng);
+
+// One tick worth of player intent. Held values are the current key state,
+// "pressed" values are edges since the previous Step.
+struct InputFrame {
+    Vector2 move{ 0, 0 };     // unnormalized, each axis in -1..1
+    bool attackPressed = false;
+    bool specialPressed = false;
+};
+
+// ---------------------------------------------------------
+// World
+// ---------------------------------------------------------
+
+struct SimWorld {
+    explicit SimWorld(int enemyCapacity = MAX_ENEMIES);
+
+    Player player{};
+    PlayerClass playerClass = PlayerClass::KNIGHT;
+    GameState state = GameState::PLAYING; // PLAYING, VICTORY or GAMEOVER
+
+    EnemyPool enemies;
+    FixedPool<Coin> coins;
+    FixedPool<Projectile> projectiles;
+
+    // Enemies bucketed by x, rebuilt every tick before hit detection
+    BroadphaseX enemyGrid;
+
+    // Optional worker pool for the enemy pass (nullptr = single-threaded).
+    // Owned by the caller; results do not depend on its thread count.
+    JobPool* jobs = nullptr;
+    std::vector<std::vector<HitEvent>> enemyHits;   // one buffer per chunk
+
+    // Everything combat produced this tick, drained by ResolveCombat
+    CombatEvents events;
+
+    bool bossSpawned = false;
+    bool bossDefeated = false;
+    float enemySpawnTimer = 0.0f;
+
+    float hitStopTimer = 0.0f;
+    int attackCounter = 0;
+    int projectileCounter = 0;
+
+    SimRng rng;
+    uint64_t tick = 0;
+
+    // Sounds requested by the last Step, in order
+    std::vector<Sfx> sfx;
+
+    void Reset(const CharacterClass& cc);
+
+    // Advance one fixed tick. prevPos of every moving entity is
+    // snapshotted first so the renderer can blend between ticks.
+    void Step(const InputFrame& input, float dt);
+
+    // Step body instantiated per class policy (see player_classes.h);
+    // Step picks the instantiation once per tick.
+    template <typename Class>
+    void StepAs(const InputFrame& input, float dt);
+
+    // Chase, timers, attacks and animation for enemies [begin, end).
+    // Safe to run concurrently on disjoint ranges.
+    void UpdateEnemyChunk(int begin, int end, float gameDt, std::vector<HitEvent>& hits);
+
+    // Applies the hits, kills, loot, state changes and sounds queued this
+    // tick. Killed enemies are flagged dead and removed at the end of Step.
+    void ResolveCombat();
+
+    // Projectiles vs the enemy grid (built this tick); queues hits
+    void CollideProjectiles();
+
+    // Ages coins and collects the ones the player touches
+    void UpdateCoins(float gameDt);
+
+    // When the pool is full the coin closest to expiring is replaced
+    void DropCoin(Vector2 pos);
+
+    // Order-sensitive hash of the gameplay state, for replay / soak checks
+    uint64_t Checksum() const;
+};
@@ -0,0 +1,143 @@
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+
+TraceRecorder tracer;
+
+static int64_t SteadyNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+TraceRecorder::~TraceRecorder() {
+    // Static destruction: every recording thread has been joined by now
+    for (ThreadBuffer* t : threads) {
+        Block* b = t->head;
+        while (b) {
+            Block* next = b->next.load(std::memory_order_relaxed);
+            delete b;
+            b = next;
+        }
+        delete t;
+    }
+}
+
+void TraceRecorder::Start(const char* outPath) {
+    path = outPath;
+    originNs = SteadyNs();
+    enabled.store(true, std::memory_order_release);
+    NameThread("main");
+}
+
+int64_t TraceRecorder::NowUs() const {
+    return (SteadyNs() - originNs) / 1000;
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::Local() {
+    thread_local ThreadBuffer* local = nullptr;
+    if (!local) {
+        ThreadBuffer* t = new ThreadBuffer();
+        t->head = t->tail = new Block();
+        t->blocks = 1;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        t->tid = (int)threads.size() + 1;
+        threads.push_back(t);
+        local = t;
+    }
+    return *local;
+}
+
+void TraceRecorder::Append(const TraceEvent& e) {
+    ThreadBuffer& t = Local();
+    Block* b = t.tail;
+    int n = b->count.load(std::memory_order_relaxed);
+    if (n == TRACE_BLOCK_EVENTS) {
+        if (t.blocks == TRACE_MAX_BLOCKS) {
+            t.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Block* fresh = new Block();
+        b->next.store(fresh, std::memory_order_release);
+        t.tail = b = fresh;
+        t.blocks++;
+        n = 0;
+    }
+    b->events[n] = e;
+    b->count.store(n + 1, std::memory_order_release);
+}
+
+void TraceRecorder::Complete(const char* name, int64_t startUs, int64_t endUs) {
+    Append({ name, startUs, endUs - startUs });
+}
+
+void TraceRecorder::Instant(const char* name) {
+    Append({ name, NowUs(), -1 });
+}
+
+void TraceRecorder::NameThread(const char* name) {
+    if (!Enabled()) return;
+    Local().name.store(name, std::memory_order_release);
+}
+
+static void WriteJsonString(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+bool TraceRecorder::Write(const char* outPath) {
+    if (!outPath) outPath = path.c_str();
+    FILE* f = fopen(outPath, "w");
+    if (!f) {
+        fprintf(stderr, "trace: cannot write %s\n", outPath);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    long long written = 0;
+    long long dropped = 0;
+    bool first = true;
+    auto separator = [&]() {
+        fputs(first ? "\n" : ",\n", f);
+        first = false;
+    };
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+    for (const ThreadBuffer* t : threads) {
+        if (const char* name = t->name.load(std::memory_order_acquire)) {
+            separator();
+            fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", t->tid);
+            WriteJsonString(f, name);
+            fputs("}}", f);
+        }
+
+        for (const Block* b = t->head; b; b = b->next.load(std::memory_order_acquire)) {
+            int n = b->count.load(std::memory_order_acquire);
+            for (int i = 0; i < n; ++i) {
+                const TraceEvent& e = b->events[i];
+                separator();
+                fputs("{\"name\":", f);
+                WriteJsonString(f, e.name);
+                if (e.durUs < 0) {
+                    fprintf(f, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld,\"pid\":1,\"tid\":%d}",
+                            (long long)e.startUs, t->tid);
+                } else {
+                    fprintf(f, ",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d}",
+                            (long long)e.startUs, (long long)e.durUs, t->tid);
+                }
+                written++;
+            }
+        }
+        dropped += t->dropped.load(std::memory_order_relaxed);
+    }
+    fputs("\n]}\n", f);
+    fclose(f);
+
+    printf("trace: wrote %lld events to %s", written, outPath);
+    if (dropped > 0) printf(" (%lld dropped, buffers full)", dropped);
+    printf("\n");
+    return true;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------
+// Trace capture (Chrome trace-event JSON, opens in Perfetto)
+//
+// Every thread that records gets its own buffer, a chain of fixed-size
+// blocks only that thread appends to, so recording takes no lock: the
+// writer fills an event, then publishes it with a release store of the
+// block's count. Write can run at any time (exit, or the F5 hotkey) and
+// reads up to the published counts.
+//
+// Scopes are complete ("X") events - one append per scope, on exit.
+// Names must be string literals or otherwise outlive the recorder.
+// Compiled out with -DNO_PROFILER, like the frame profiler.
+// ---------------------------------------------------------
+
+static const int TRACE_BLOCK_EVENTS = 4096;
+static const int TRACE_MAX_BLOCKS = 1024;    // per thread, ~96 MB worst case
+
+struct TraceEvent {
+    const char* name;
+    int64_t startUs;
+    int64_t durUs;    // -1 = instant event
+};
+
+struct TraceRecorder {
+    ~TraceRecorder();
+
+    bool Enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Starts recording; Write with no argument goes to `path`
+    void Start(const char* path);
+
+    // Microseconds since Start
+    int64_t NowUs() const;
+    int64_t FromSteadyMs(double ms) const { return (int64_t)(ms * 1000.0) - originNs / 1000; }
+
+    // Recording, from any thread
+    void Complete(const char* name, int64_t startUs, int64_t endUs);
+    void Instant(const char* name);
+
+    // Labels the calling thread in the viewer (only while recording, so
+    // idle threads never get a buffer)
+    void NameThread(const char* name);
+
+    // False if the file can't be written
+    bool Write(const char* path = nullptr);
+
+private:
+    struct Block {
+        TraceEvent events[TRACE_BLOCK_EVENTS];
+        std::atomic<int> count{ 0 };
+        std::atomic<Block*> next{ nullptr };
+    };
+
+    struct ThreadBuffer {
+        int tid = 0;
+        std::atomic<const char*> name{ nullptr };
+        Block* head = nullptr;
+        Block* tail = nullptr;          // writer only
+        int blocks = 0;                 // writer only
+        std::atomic<int> dropped{ 0 };
+    };
+
+    ThreadBuffer& Local();
+    void Append(const TraceEvent& e);
+
+    std::atomic<bool> enabled{ false };
+    std::string path;
+    int64_t originNs = 0;
+
+    std::mutex registryMutex;           // thread registration and Write only
+    std::vector<ThreadBuffer*> threads;
+};
+
+extern TraceRecorder tracer;
+
+// Times the enclosing scope into the trace
+struct TraceScope {
+    explicit TraceScope(const char* n) : name(n), start(tracer.Enabled() ? tracer.NowUs() : -1) {}
+    ~TraceScope() {
+        if (start >= 0) tracer.Complete(name, start, tracer.NowUs());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#if defined(NO_PROFILER)
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_INSTANT(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#else
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_INSTANT(name) do { if (tracer.Enabled()) tracer.Instant(name); } while (0)
+#define TRACE_THREAD_NAME(name) tracer.NameThread(name)
+#endif
@@ -0,0 +1,93 @@
+#include "voices.h"
+#include <algorithm>
+
+void VoicePool::Init(AudioMixer& m) {
+    mixer = &m;
+    voiceCount = 0;
+    for (int s = 0; s < SOUND_COUNT; ++s) {
+        firstVoice[s] = voiceCount;
+        if (m.SoundLength((Sfx)s) <= 0.0f) continue;   // missing file: silent
+
+        int n = std::min(SFX_VOICE_CONFIG[s].maxVoices, VOICE_MAX_PER_SOUND);
+        for (int v = 0; v < n; ++v) {
+            voices[voiceCount++] = Voice{ (Sfx)s, 0, 0.0 };
+        }
+    }
+    firstVoice[SOUND_COUNT] = voiceCount;
+}
+
+void VoicePool::Request(Sfx s) {
+    current.requested++;
+    if (pending[(int)s]) current.deduped++;
+    pending[(int)s] = true;
+}
+
+VoicePool::Voice* VoicePool::PickVoice(Sfx s) {
+    int begin = firstVoice[(int)s];
+    int end = firstVoice[(int)s + 1];
+
+    // A free voice of this sound, else its oldest (per-sound cap)
+    Voice* own = nullptr;
+    for (int i = begin; i < end; ++i) {
+        if (!Sounding(voices[i])) {
+            own = &voices[i];
+            break;
+        }
+        if (!own || voices[i].started < own->started) own = &voices[i];
+    }
+    if (Sounding(*own)) return own;   // restarting our own voice keeps the total unchanged
+
+    int sounding = 0;
+    for (int i = 0; i < voiceCount; ++i) sounding += Sounding(voices[i]) ? 1 : 0;
+    if (sounding < VOICE_LIMIT) return own;
+
+    // Over the global limit: silence the oldest lower-priority voice
+    int priority = SFX_VOICE_CONFIG[(int)s].priority;
+    Voice* victim = nullptr;
+    for (int i = 0; i < voiceCount; ++i) {
+        Voice& v = voices[i];
+        if (!Sounding(v) || SFX_VOICE_CONFIG[(int)v.sound].priority >= priority) continue;
+        if (!victim || v.started < victim->started) victim = &v;
+    }
+    if (!victim) return nullptr;
+
+    mixer->Stop((int)(victim - voices));
+    victim->endTime = 0.0;
+    current.stolen++;
+    return own;
+}
+
+void VoicePool::Flush(double time) {
+    now = time;
+
+    // Highest priority first; ties keep Sfx order
+    int order[SOUND_COUNT];
+    int n = 0;
+    for (int s = 0; s < SOUND_COUNT; ++s) {
+        if (pending[s]) order[n++] = s;
+    }
+    std::stable_sort(order, order + n, [](int a, int b) {
+        return SFX_VOICE_CONFIG[a].priority > SFX_VOICE_CONFIG[b].priority;
+    });
+
+    for (int k = 0; k < n; ++k) {
+        Sfx s = (Sfx)order[k];
+        pending[(int)s] = false;
+        if (firstVoice[(int)s] == firstVoice[(int)s + 1]) continue;   // not loaded
+
+        // Only a play the mixer queued occupies the voice and counts; a
+        // mixer that never started (no audio device) plays nothing
+        Voice* v = current.played < VOICE_PLAYS_PER_FRAME ? PickVoice(s) : nullptr;
+        if (!v || !mixer->Play((int)(v - voices), s)) {   // restarts it if it was still playing
+            current.dropped++;
+            continue;
+        }
+        v->started = frame;
+        v->endTime = now + mixer->SoundLength(s);
+        current.played++;
+    }
+
+    frame++;
+    stats = current;
+    current = VoiceStats{};
+}
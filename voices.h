@@ -0,0 +1,91 @@
+#pragma once
+
+#include "raylib.h"
+#include "events.h"
+#include "audio.h"
+
+// ---------------------------------------------------------
+// Sound voices
+//
+// The sim can ask for the same sound dozens of times in one frame (a
+// projectile piercing a crowd, a finisher landing on a pack). Requests
+// are collected for the frame and Flush plays each sound at most once,
+// on one of a few mixer voices reserved for it:
+//
+//   - dedupe:   repeats of a sound within a frame collapse into one play
+//   - cap:      a sound never has more than maxVoices playing; a new play
+//               restarts its oldest voice
+//   - budget:   at most VOICE_PLAYS_PER_FRAME new plays per frame,
+//               highest priority first
+//   - stealing: with VOICE_LIMIT voices already sounding, a play takes
+//               over the oldest voice of a lower-priority sound, or is
+//               dropped if there is none
+// ---------------------------------------------------------
+
+static const int VOICE_LIMIT = 12;
+static const int VOICE_PLAYS_PER_FRAME = 4;
+static const int VOICE_MAX_PER_SOUND = 4;
+
+struct SfxVoiceConfig {
+    int maxVoices;   // <= VOICE_MAX_PER_SOUND
+    int priority;    // higher wins budget and steals
+};
+
+// Indexed by Sfx. Player feedback outranks combat noise.
+constexpr SfxVoiceConfig SFX_VOICE_CONFIG[SOUND_COUNT] = {
+    //  voices  priority
+    { 2, 3 },   // KNIGHT_SWING
+    { 2, 3 },   // ROGUE_SWING
+    { 2, 3 },   // MAGE_CAST
+    { 4, 2 },   // HIT
+    { 3, 1 },   // ENEMY_SWING
+    { 1, 4 },   // BLOCK
+    { 1, 4 },   // DODGE
+    { 1, 4 },   // BLINK
+};
+static_assert(SOUND_COUNT == 8, "add the new sound to SFX_VOICE_CONFIG");
+static_assert(SOUND_COUNT * VOICE_MAX_PER_SOUND <= MIXER_VOICES, "not enough mixer voices");
+
+struct VoiceStats {
+    int requested;
+    int played;
+    int deduped;   // repeats within the frame
+    int stolen;    // lower-priority voices cut off
+    int dropped;   // over budget, nothing to steal, or not queued by the mixer
+};
+
+struct VoicePool {
+    VoiceStats stats{};   // last flushed frame
+
+    // Reserves mixer voices for every sound the mixer has a clip for.
+    // Call after the clips are set; `mixer` must outlive the pool.
+    void Init(AudioMixer& mixer);
+
+    void Request(Sfx s);
+
+    // Once per frame: sends this frame's plays to the mixer. `now` is in
+    // seconds and only has to be monotonic.
+    void Flush(double now);
+
+private:
+    struct Voice {
+        Sfx sound = Sfx::COUNT;
+        unsigned started = 0;   // frame it last started; 0 = never
+        double endTime = 0.0;   // start + clip length
+    };
+
+    // Tracked here from the clip lengths, so the game thread never has to
+    // ask the audio thread what is playing
+    bool Sounding(const Voice& v) const { return v.started != 0 && now < v.endTime; }
+    Voice* PickVoice(Sfx s);
+
+    AudioMixer* mixer = nullptr;
+    Voice voices[SOUND_COUNT * VOICE_MAX_PER_SOUND];   // index = mixer voice
+    int voiceCount = 0;
+    int firstVoice[SOUND_COUNT + 1] = {};   // voices of sound s: [firstVoice[s], firstVoice[s + 1])
+
+    VoiceStats current{};
+    bool pending[SOUND_COUNT] = {};
+    unsigned frame = 1;
+    double now = 0.0;
+};